@@ -0,0 +1,65 @@
+/* .....................................................................
+ * benchmark_uncontended_acquire
+ * Measures the cost of a get_item() / set_item() pair when the pool
+ * has free items and a single thread uses it, with and without metrics
+ * and with different policies.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool.h"
+#include <chrono>
+#include <string>
+
+using namespace std;
+
+const int iterations = 5000000;		// acquire / release pairs measured on each case
+const int pool_size = 16;			// Size of pool ( amount of resources )
+
+// class used in pool simulating some resource
+class Foo {
+public:
+	Foo() {}
+	int value = 0;
+};
+
+// run()
+// returns the average nanoseconds of an acquire / release pair
+template <class P, class A> double run(P& pool, A acquire)
+{
+	auto t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+	{
+		typename P::item c = acquire(pool);
+		c->value++;
+		pool.set_item(c);
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+}
+
+void report(const string& name, double ns)
+{
+	cout << name << " : " << ns << " ns per acquire/release" << endl;
+}
+
+int main()
+{
+	typedef interactive_pool< Foo > classic_pool;
+	typedef interactive_pool< Foo, interactive_spin_lock, interactive_lifo_order > fast_pool;
+
+	classic_pool pool(pool_size);
+	fast_pool fast(pool_size);
+
+	// no metric requested, no clock is read
+	report("classic pool, no metric       ", run(pool, [](classic_pool& p) { return p.get_item(); }));
+	report("classic pool, zero timeout    ", run(pool, [](classic_pool& p) { return p.get_item(0); }));
+	// metric requested, two clock reads per acquisition
+	report("classic pool, with metric     ", run(pool, [](classic_pool& p) { interactive_pool_time t; return p.get_item(0, &t); }));
+	report("spin lock + lifo, no metric   ", run(fast, [](fast_pool& p) { return p.get_item(0); }));
+
+	pool.check_before_destruct();
+	fast.check_before_destruct();
+
+	cout << "End of example " << endl;
+	return 0;
+}
@@ -0,0 +1,78 @@
+/* .....................................................................
+ * keyed_pool_per_shard
+ * One interactive_keyed_pool serves the connections of several shards.
+ * The connections are created on demand for each shard, and when the
+ * global limit is reached the idle connections of the cold shards are
+ * destroyed to serve the busy ones.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int shards = 6;				// number of keys of the pool
+const int threads = 6;				// Working threads , that consumes thepool resources
+const int operations = 50;			// Count of writes of each thread before to finish
+const int work_duration_ms = 2;		// fake value in ms simulating a task duration
+
+// class used in pool simulating a connection to one shard
+class ShardConnection {
+public:
+	explicit ShardConnection(int shard) : _shard(shard) {}
+	void Write()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(work_duration_ms));
+	}
+	int shard() const { return _shard; }
+private:
+	int _shard;
+};
+
+typedef interactive_keyed_pool< int, ShardConnection > shard_pool;
+
+// worker thread, the first half of the shards are hot, the rest are used now and then
+void worker(shard_pool* pool, int n)
+{
+	for (int i = 0; i < operations; i++)
+	{
+		int shard = (i % 10 == 0) ? (shards / 2 + (n + i) % (shards / 2)) : (n % (shards / 2));
+		try
+		{
+			shard_pool::item c = pool->get_item(shard, 1000);
+			c->Write();
+			pool->set_item(shard, c);
+		}
+		catch (std::exception& e)
+		{
+			cout << "Thread " << std::this_thread::get_id() << " Exception " << string(e.what()) << endl;
+		}
+	}
+}
+
+int main(int, char**)
+{
+	// at least 1 connection per shard, at most 4 per shard and 8 in total
+	shard_pool pool(1, 4, 8, [](const int& shard) { return std::make_unique<ShardConnection>(shard); });
+
+	vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.push_back(std::thread(worker, &pool, i));
+	}
+	std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+
+	for (int shard = 0; shard < shards; shard++)
+	{
+		cout << "Shard " << shard << ": " << pool.get_available_count(shard) << " idle connections" << endl;
+	}
+	cout << "Connections: " << pool.get_total_count() << ", evicted: " << pool.get_eviction_count() << endl;
+
+	pool.check_before_destruct();
+	return 0;
+}
@@ -0,0 +1,72 @@
+/* .....................................................................
+ * numa_pool
+ * interactive_numa_pool keeps one pool per memory node, each thread
+ * gets the items of its own node first. On hosts with a single node
+ * (or without the topology) it works as a single pool.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int threads = 8;				// Working threads , that consumes thepool resources
+const int operations = 100;			// Count of writes of each thread before to finish
+const int pool_size = 8;			// Size of pool ( amount of resources )
+
+// class used in pool simulating a buffer, its memory is allocated in the node of the thread that creates it
+class Foo {
+public:
+	Foo() : _buffer(64 * 1024, 0) {}
+	void Write()
+	{
+		std::fill(_buffer.begin(), _buffer.end(), 1);
+	}
+	void Clear()
+	{
+		std::fill(_buffer.begin(), _buffer.end(), 0);
+	}
+private:
+	std::vector<char> _buffer;
+};
+
+// worker thread
+void worker(interactive_numa_pool< Foo >* pool)
+{
+	for (int i = 0; i < operations; i++)
+	{
+		try
+		{
+			interactive_numa_pool< Foo >::item c = pool->get_item(1000);
+			c->Write();
+			pool->set_item(c);
+		}
+		catch (std::exception& e)
+		{
+			cout << "Thread " << std::this_thread::get_id() << " Exception " << string(e.what()) << endl;
+		}
+	}
+}
+
+int main(int, char**)
+{
+	// the buffers are cleaned when they come back
+	interactive_numa_pool< Foo > pool(pool_size, [](Foo& f) { f.Clear(); });
+	cout << "Memory nodes: " << pool.get_node_count() << ", main thread on node " << pool.current_node() << endl;
+
+	vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.push_back(std::thread(worker, &pool));
+	}
+	std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+
+	cout << "Free items: " << pool.get_available_count() << endl;
+	pool.check_before_destruct();
+	return 0;
+}
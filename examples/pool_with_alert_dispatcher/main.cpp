@@ -0,0 +1,87 @@
+/* .....................................................................
+ * pool_with_alert_dispatcher
+ * The alert function is slow (it simulates a call to a remote service).
+ * With interactive_alert_dispatcher the detector only queues the alert
+ * and the function runs in the dispatcher thread, so the threads that
+ * use the pool are not delayed by it.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int threads = 4;				// Working threads , that consumes thepool resources
+const int interval = 1;				// Interval on each thread iteration
+const int operations = 50;			// Count of writes of each thread before to finish
+const int work_duration_ms = 2;		// fake value in ms simulating a task duration
+const int alert_duration_ms = 20;	// fake value in ms simulating the delivery of an alert
+const int pool_size = 2;			// Size of pool ( amount of resources )
+
+// class used in pool simulating some resource
+class Foo {
+public:
+	Foo() {}
+	void Write()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(work_duration_ms));
+	}
+};
+
+// slow alert, called from the dispatcher thread
+void alarm_function(const std::string& id, interactive_pool_duration level, interactive_pool_duration value)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(alert_duration_ms));
+	cout << id << " waited " << std::chrono::duration_cast<std::chrono::microseconds>(value).count() << " us for an item, above "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(level).count() << " us" << endl;
+}
+
+// worker thread
+void worker(interactive_pool< Foo >* pool)
+{
+	for (int i = 0; i < operations; i++)
+	{
+		try
+		{
+			interactive_pool_lease<Foo> c(pool, 1000);
+			c->Write();
+		}
+		catch (std::exception& e)
+		{
+			cout << "Thread " << std::this_thread::get_id() << " Exception " << string(e.what()) << endl;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+	}
+}
+
+int main(int, char**)
+{
+	// declared before the detector, it must outlive it. Up to 16 alerts waiting, the rest are dropped
+	interactive_alert_dispatcher< std::string > dispatcher(16);
+	interactive_shared_peak_detector< std::string > peak(string("Foo pool"), std::chrono::milliseconds(1), dispatcher.wrap(&alarm_function));
+
+	interactive_pool< Foo > pool(pool_size);
+	pool.set_acquire_detector(&peak);
+
+	auto t0 = interactive_pool_clock::now();
+	vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.push_back(std::thread(worker, &pool));
+	}
+	std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(interactive_pool_clock::now() - t0);
+
+	pool.set_acquire_detector(nullptr);
+	cout << "Workers finished in " << elapsed.count() << " ms, with " << peak.get_fired_count() << " alerts: "
+		<< dispatcher.get_dispatched_count() << " delivered so far, " << dispatcher.get_overflow_count() << " dropped" << endl;
+
+	pool.check_before_destruct();
+	// the destructor of the dispatcher delivers the alerts still queued
+	return 0;
+}
@@ -0,0 +1,100 @@
+/* .....................................................................
+ * pool_with_ewma_detector
+ * Watches the hold time of the items with an exponentially weighted
+ * average. The smoothed time raises the alarm when the tasks become
+ * slow, and the z-score alarm catches a single task far above the usual.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int threads = 2;				// Working threads , that consumes thepool resources
+const int operations = 150;			// Count of writes of each thread before to finish
+const int pool_size = 2;			// Size of pool ( amount of resources )
+
+// class used in pool simulating some resource
+class Foo {
+public:
+	Foo() {}
+	void Write(int duration_ms)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+	}
+};
+
+// task duration: 2 ms, one spike of 40 ms, and the last third of the tasks become slow (10 ms)
+int task_duration(int i)
+{
+	if (i == operations / 3)
+	{
+		return 40;
+	}
+	return (i > 2 * operations / 3) ? 10 : 2;
+}
+
+// worker thread
+void worker(interactive_pool< Foo >* pool)
+{
+	for (int i = 0; i < operations; i++)
+	{
+		try
+		{
+			interactive_pool_lease<Foo> c(pool, 1000);
+			c->Write(task_duration(i));
+		}
+		catch (std::exception& e)
+		{
+			cout << "Thread " << std::this_thread::get_id() << " Exception " << string(e.what()) << endl;
+		}
+	}
+}
+
+const interactive_pool_duration trigger_level = std::chrono::milliseconds(6);
+std::atomic<int> smoothed_alarms(0);	// calls for the smoothed time
+std::atomic<int> sample_alarms(0);		// calls for a single sample (z-score)
+
+// the level tells the kind of alarm: the trigger level, or the limit of the z-score for that sample
+void ewma_alarm(const std::string& id, interactive_pool_duration level, interactive_pool_duration value)
+{
+	std::atomic<int>& counter = (level == trigger_level) ? smoothed_alarms : sample_alarms;
+	if (counter++ == 0)
+	{
+		cout << id << ((level == trigger_level) ? " smoothed hold time " : " a task took ")
+			<< std::chrono::duration_cast<std::chrono::microseconds>(value).count() << " us, above "
+			<< std::chrono::duration_cast<std::chrono::microseconds>(level).count() << " us" << endl;
+	}
+}
+
+int main(int, char**)
+{
+	// alpha 0.1 (about the last 10 samples), alarm when the smoothed time is above 6 ms
+	// or a sample is 20 deviations above the smoothed time
+	interactive_ewma_detector< std::string > ewma(string("Foo pool"), 0.1, trigger_level, &ewma_alarm, 20.0);
+
+	interactive_pool< Foo > pool(pool_size);
+	pool.enable_hold_tracking();
+	pool.set_hold_detector(&ewma);
+
+	vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.push_back(std::thread(worker, &pool));
+	}
+	std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+
+	pool.set_hold_detector(nullptr);
+	cout << "Alarms of the smoothed time: " << smoothed_alarms << ", of a single task: " << sample_alarms << endl;
+	cout << "Smoothed hold time " << std::chrono::duration_cast<std::chrono::microseconds>(ewma.mean()).count()
+		<< " us, deviation " << std::chrono::duration_cast<std::chrono::microseconds>(ewma.deviation()).count() << " us" << endl;
+
+	pool.check_before_destruct();
+	return 0;
+}
@@ -0,0 +1,79 @@
+/* .....................................................................
+ * pool_with_hold_watchdog
+ * One of the threads keeps an item much longer than the others, as if
+ * it was stuck. The detectors only see the hold time when the item comes
+ * back, interactive_hold_watchdog reports it while it is still held.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int threads = 3;				// Working threads , that consumes thepool resources
+const int operations = 20;			// Count of writes of each thread before to finish
+const int work_duration_ms = 10;	// fake value in ms simulating a task duration
+const int stuck_duration_ms = 800;	// fake value in ms of the stuck task
+const int pool_size = 2;			// Size of pool ( amount of resources )
+
+// class used in pool simulating some resource
+class Foo {
+public:
+	Foo() {}
+	void Write(int duration_ms)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+	}
+};
+
+// worker thread, the first one gets stuck in its fifth task
+void worker(interactive_pool< Foo >* pool, int n)
+{
+	for (int i = 0; i < operations; i++)
+	{
+		try
+		{
+			interactive_pool_lease<Foo> c(pool, 1000);
+			c.tag(n == 0 ? "stuck worker" : "worker");
+			c->Write((n == 0 && i == 4) ? stuck_duration_ms : work_duration_ms);
+		}
+		catch (std::exception& e)
+		{
+			cout << "Thread " << std::this_thread::get_id() << " Exception " << string(e.what()) << endl;
+		}
+	}
+}
+
+int main(int, char**)
+{
+	interactive_pool< Foo > pool(pool_size);
+
+	// items held more than 200 ms, checked every 50 ms. It enables the lease registry of the pool
+	interactive_hold_watchdog< std::string, interactive_pool< Foo > > watchdog(string("Foo pool"), &pool,
+		std::chrono::milliseconds(200), std::chrono::milliseconds(50),
+		[&pool](const std::string& id, interactive_pool_duration, interactive_pool_duration value)
+		{
+			cout << id << ": an item is held for " << std::chrono::duration_cast<std::chrono::milliseconds>(value).count() << " ms" << endl;
+			// who has it
+			for (const interactive_pool_lease_info& i : pool.outstanding_leases())
+			{
+				cout << "    thread " << i.owner << " " << (i.tag ? i.tag : "") << " for "
+					<< std::chrono::duration_cast<std::chrono::milliseconds>(i.held).count() << " ms" << endl;
+			}
+		});
+
+	vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.push_back(std::thread(worker, &pool, i));
+	}
+	std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+
+	pool.check_before_destruct();
+	return 0;
+}
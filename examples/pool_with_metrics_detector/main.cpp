@@ -0,0 +1,80 @@
+/* .....................................................................
+ * pool_with_metrics_detector
+ * Attaches a shared peak detector to the pool through the MetricsPolicy,
+ * so the time of every acquisition is checked without passing a detector
+ * to each get_item() call.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int threads = 8;				// Working threads , that consumes thepool resources
+const int operations = 20;			// Count of writes of each thread before to finish
+const int work_duration_ms = 5;		// fake value in ms simulating a task duration
+const int pool_size = 2;			// Size of pool ( amount of resources )
+
+// class used in pool simulating some resource
+class Foo {
+public:
+	Foo() {}
+	void Write()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(work_duration_ms));
+	}
+};
+
+// the detector is owned by the caller, the pool keeps a reference to it
+typedef interactive_shared_peak_detector< std::string > peak_detector;
+typedef interactive_pool< Foo, std::mutex, interactive_fifo_order, interactive_no_validator, interactive_metrics_ref< peak_detector > > metered_pool;
+
+// worker thread
+void worker(metered_pool* pool)
+{
+	for (int i = 0; i < operations; i++)
+	{
+		try
+		{
+			interactive_pool_lease< Foo, metered_pool > c(pool, 1000);
+			c->Write();
+		}
+		catch (std::exception& e)
+		{
+			cout << "Thread " << std::this_thread::get_id() << " Exception " << string(e.what()) << endl;
+		}
+	}
+}
+
+int main(int, char**)
+{
+	// alarm when a thread waits more than 10 ms for an item
+	peak_detector peak(string("Connection Pool 1"), std::chrono::milliseconds(10),
+		[](const std::string& id, interactive_pool_duration, interactive_pool_duration value)
+		{
+			cout << id << " waited " << std::chrono::duration_cast<std::chrono::milliseconds>(value).count() << " ms for an item" << endl;
+		});
+
+	{
+		metered_pool pool(pool_size, {}, peak);
+
+		vector<std::thread> workers;
+		for (int i = 0; i < threads; i++)
+		{
+			workers.push_back(std::thread(worker, &pool));
+		}
+		std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+
+		pool.check_before_destruct();
+	}
+
+	cout << "Acquisitions above the trigger: " << peak.get_peak_count()
+		<< ", alarms: " << peak.get_fired_count()
+		<< ", longest wait: " << std::chrono::duration_cast<std::chrono::milliseconds>(peak.get_max()).count() << " ms" << endl;
+	return 0;
+}
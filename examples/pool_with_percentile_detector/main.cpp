@@ -0,0 +1,82 @@
+/* .....................................................................
+ * pool_with_percentile_detector
+ * Watches the p99 of the time the items are held. Most tasks are fast
+ * but a few of them are slow, the average stays low while the tail is
+ * above the trigger level and the alarm fires.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int threads = 4;				// Working threads , that consumes thepool resources
+const int operations = 300;			// Count of writes of each thread before to finish
+const int slow_every = 30;			// one task of each slow_every is slow
+const int pool_size = 4;			// Size of pool ( amount of resources )
+
+// class used in pool simulating some resource
+class Foo {
+public:
+	Foo() {}
+	void Write(bool slow)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(slow ? 20 : 1));
+	}
+};
+
+// worker thread
+void worker(interactive_pool< Foo >* pool)
+{
+	for (int i = 0; i < operations; i++)
+	{
+		try
+		{
+			interactive_pool_lease<Foo> c(pool, 1000);
+			c->Write(i % slow_every == 0);
+		}
+		catch (std::exception& e)
+		{
+			cout << "Thread " << std::this_thread::get_id() << " Exception " << string(e.what()) << endl;
+		}
+	}
+}
+
+int main(int, char**)
+{
+	// p99 of the last 200 hold times (checked over the last 200 to 400) above 10 ms.
+	// Reported at most once every 500 ms, with the number of times it fired in between
+	interactive_percentile_detector< std::string > p99(string("Foo pool"), 99, std::chrono::milliseconds(10), size_t(200),
+		[](const std::string&, interactive_pool_duration, interactive_pool_duration) {});
+	p99.set_debounce(std::chrono::milliseconds(10), std::chrono::milliseconds(500),
+		[](const std::string& id, interactive_pool_duration level, interactive_pool_duration value, uint64_t times)
+		{
+			cout << id << " p99 of the hold time " << std::chrono::duration_cast<std::chrono::milliseconds>(value).count()
+				<< " ms is above " << std::chrono::duration_cast<std::chrono::milliseconds>(level).count()
+				<< " ms (" << times << " times)" << endl;
+		});
+
+	interactive_pool< Foo > pool(pool_size);
+	pool.enable_hold_tracking();
+	pool.set_hold_detector(&p99);
+
+	vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.push_back(std::thread(worker, &pool));
+	}
+	std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+
+	pool.set_hold_detector(nullptr);
+	cout << "Alarms: " << p99.get_fired_count()
+		<< ", p50: " << std::chrono::duration_cast<std::chrono::microseconds>(p99.snapshot().percentile(50)).count() << " us"
+		<< ", p99: " << std::chrono::duration_cast<std::chrono::microseconds>(p99.value()).count() << " us" << endl;
+
+	pool.check_before_destruct();
+	return 0;
+}
@@ -0,0 +1,81 @@
+/* .....................................................................
+ * pool_with_prometheus_exporter
+ * Several threads use a pool with the latency histograms enabled, while
+ * the main thread exports its metrics in Prometheus text format, to the
+ * console and to a file for the textfile collector of node_exporter.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool_prometheus.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int threads = 8;				// Working threads , that consumes thepool resources
+const int operations = 200;			// Count of writes of each thread before to finish
+const int work_duration_ms = 2;		// fake value in ms simulating a task duration
+const int pool_size = 4;			// Size of pool ( amount of resources )
+
+// class used in pool simulating some resource
+class Foo {
+public:
+	Foo() {}
+	void Write()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(work_duration_ms));
+	}
+};
+
+// worker thread
+void worker(interactive_pool< Foo >* pool)
+{
+	for (int i = 0; i < operations; i++)
+	{
+		try
+		{
+			interactive_pool_lease<Foo> c(pool, 1000);
+			c->Write();
+		}
+		catch (std::exception& e)
+		{
+			cout << "Thread " << std::this_thread::get_id() << " Exception " << string(e.what()) << endl;
+		}
+	}
+}
+
+int main(int, char**)
+{
+	interactive_pool< Foo > pool(pool_size);
+	// summaries of the time to get an item and of the time it is held
+	pool.enable_acquire_histogram();
+	pool.enable_hold_tracking();
+
+	interactive_pool_prometheus_exporter exporter;
+	exporter.register_pool("foo", &pool);
+
+	vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.push_back(std::thread(worker, &pool));
+	}
+
+	// export while the pool is in use, ex. from the /metrics handler of a http server
+	for (int i = 0; i < 3; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		if (!exporter.write_file("interactive_pool.prom"))
+		{
+			cout << "interactive_pool.prom could not be written" << endl;
+		}
+	}
+
+	std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+
+	cout << exporter.render();
+
+	exporter.unregister_pool("foo");
+	pool.check_before_destruct();
+	return 0;
+}
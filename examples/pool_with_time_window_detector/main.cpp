@@ -0,0 +1,92 @@
+/* .....................................................................
+ * pool_with_time_window_detector
+ * Averages the time to get an item over the last 200 ms, whatever the
+ * request rate. The pool is quiet at first, then more threads than items
+ * compete for it and the average of the window goes above the trigger.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int quiet_threads = 2;		// threads of the first phase, no more than the items
+const int busy_threads = 8;			// threads of the second phase
+const int operations = 40;			// Count of writes of each thread before to finish
+const int work_duration_ms = 3;		// fake value in ms simulating a task duration
+const int pool_size = 2;			// Size of pool ( amount of resources )
+
+// class used in pool simulating some resource
+class Foo {
+public:
+	Foo() {}
+	void Write()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(work_duration_ms));
+	}
+};
+
+// worker thread
+void worker(interactive_pool< Foo >* pool)
+{
+	for (int i = 0; i < operations; i++)
+	{
+		try
+		{
+			interactive_pool_lease<Foo> c(pool, 1000);
+			c->Write();
+		}
+		catch (std::exception& e)
+		{
+			cout << "Thread " << std::this_thread::get_id() << " Exception " << string(e.what()) << endl;
+		}
+	}
+}
+
+// runs a phase with the given number of threads
+void run(interactive_pool< Foo >* pool, int threads)
+{
+	vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.push_back(std::thread(worker, pool));
+	}
+	std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+}
+
+int main(int, char**)
+{
+	// average of the last 200 ms, in buckets of 20 ms, above 3 ms with at least 10 samples.
+	// The alarm ends below 1 ms, one call every 200 ms at most
+	interactive_time_window_average_detector< std::string > average(string("Foo pool"), std::chrono::milliseconds(200), std::chrono::milliseconds(20),
+		std::chrono::milliseconds(3), [](const std::string&, interactive_pool_duration, interactive_pool_duration) {}, 10);
+	average.set_debounce(std::chrono::milliseconds(1), std::chrono::milliseconds(200),
+		[](const std::string& id, interactive_pool_duration level, interactive_pool_duration value, uint64_t times)
+		{
+			cout << id << " average wait of the last 200 ms " << std::chrono::duration_cast<std::chrono::microseconds>(value).count()
+				<< " us, above " << std::chrono::duration_cast<std::chrono::microseconds>(level).count()
+				<< " us (" << times << " times)" << endl;
+		});
+
+	interactive_pool< Foo > pool(pool_size);
+	pool.set_acquire_detector(&average);
+
+	cout << "Quiet phase, " << quiet_threads << " threads" << endl;
+	run(&pool, quiet_threads);
+	cout << "Average wait " << std::chrono::duration_cast<std::chrono::microseconds>(average.average()).count()
+		<< " us of " << average.get_sample_count() << " samples" << endl;
+
+	cout << "Busy phase, " << busy_threads << " threads" << endl;
+	run(&pool, busy_threads);
+	cout << "Average wait " << std::chrono::duration_cast<std::chrono::microseconds>(average.average()).count()
+		<< " us of " << average.get_sample_count() << " samples" << endl;
+
+	pool.set_acquire_detector(nullptr);
+	pool.check_before_destruct();
+	return 0;
+}
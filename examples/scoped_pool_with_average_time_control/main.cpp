@@ -68,10 +68,10 @@ void worker_with_scope_average_detector(interactive_pool< Foo > * pool)
 	//	-> id, same as constructor
 	//  -> trigger_level , same tha constructor
 	//	-> sample_average_alarm : average calculate when is above the threshold
-	interactive_average_detector<std::thread::id> _average ( std::this_thread::get_id(), 5, 1300,
-		[]( const std::thread::id& id, uint32_t trigger_level, uint32_t sample_average_alarm )
+	interactive_average_detector<std::thread::id> _average ( std::this_thread::get_id(), 5, std::chrono::milliseconds(1300),
+		[]( const std::thread::id& id, interactive_pool_duration trigger_level, interactive_pool_duration sample_average_alarm )
 		{
-			cout << "Average time to get an instance from the pool has exceeded the threshold (" << trigger_level << "ms) connection time: " << sample_average_alarm << "ms. " << " Informer Thread : " << id << endl;
+			cout << "Average time to get an instance from the pool has exceeded the threshold (" << std::chrono::duration_cast<std::chrono::milliseconds>(trigger_level).count() << "ms) connection time: " << std::chrono::duration_cast<std::chrono::milliseconds>(sample_average_alarm).count() << "ms. " << " Informer Thread : " << id << endl;
 		}
 	);
 	
@@ -0,0 +1,95 @@
+/* .....................................................................
+ * scoped_pool_with_composite_detector
+ * A scoped handler takes one detector. interactive_composite_detector
+ * gives the time of each acquisition to a peak, an average and a
+ * percentile detector at once, each one with its own alarm.
+ * LICENSE: MIT
+ * ..................................................................... */
+#include <iostream>
+#include "./../../include/interactive_pool.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int threads = 6;				// Working threads , that consumes thepool resources
+const int interval = 1;				// Interval on each thread iteration
+const int operations = 30;			// Count of writes of each thread before to finish
+const int work_duration_ms = 5;		// fake value in ms simulating a task duration
+const int pool_size = 2;			// Size of pool ( amount of resources )
+
+// class used in pool simulating some resource
+class Foo {
+public:
+	Foo() {}
+	void Write()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(work_duration_ms));
+	}
+};
+
+// same function for all the detectors, the id tells which one fired.
+// times : fires since the previous call, value : the current value (below the level when the alarm has just ended)
+void alarm_function(const std::string& id, interactive_pool_duration level, interactive_pool_duration value, uint64_t times)
+{
+	cout << id << ": " << times << " times above " << std::chrono::duration_cast<std::chrono::milliseconds>(level).count()
+		<< " ms, now " << std::chrono::duration_cast<std::chrono::milliseconds>(value).count() << " ms" << endl;
+}
+
+void no_function(const std::string&, interactive_pool_duration, interactive_pool_duration)
+{
+}
+
+// the detectors are shared by all the threads, so they are the thread safe ones
+interactive_shared_peak_detector< std::string > peak(string("peak"), std::chrono::milliseconds(25), &no_function);
+interactive_ewma_detector< std::string > average(string("smoothed average"), 0.1, std::chrono::milliseconds(10), &no_function);
+interactive_percentile_detector< std::string > p90(string("p90"), 90, std::chrono::milliseconds(20), size_t(50), &no_function);
+
+// worker thread
+void worker(interactive_pool< Foo >* pool, base_detector* detectors)
+{
+	for (int i = 0; i < operations; i++)
+	{
+		try
+		{
+			// the handler gives the time to get the item to the detector
+			interactive_pool_time elapsedTime;
+			interactive_pool_scoped_connection<Foo> c(pool, 1000, &elapsedTime, detectors);
+			c->Write();
+		}
+		catch (std::exception& e)
+		{
+			cout << "Thread " << std::this_thread::get_id() << " Exception " << string(e.what()) << endl;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+	}
+}
+
+int main(int, char**)
+{
+	// each alarm ends at half of its trigger level, one call every 100 ms at most
+	peak.set_debounce(std::chrono::microseconds(12500), std::chrono::milliseconds(100), &alarm_function);
+	average.set_debounce(std::chrono::milliseconds(5), std::chrono::milliseconds(100), &alarm_function);
+	p90.set_debounce(std::chrono::milliseconds(10), std::chrono::milliseconds(100), &alarm_function);
+
+	// the types are deduced, each detector is called directly
+	auto detectors = interactive_make_composite_detector(peak, average, p90);
+
+	interactive_pool< Foo > pool(pool_size);
+
+	vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	{
+		workers.push_back(std::thread(worker, &pool, &detectors));
+	}
+	std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+
+	cout << "peak: " << peak.get_fired_count() << " fired, smoothed average: " << average.get_fired_count()
+		<< " fired, p90: " << p90.get_fired_count() << " fired" << endl;
+
+	pool.check_before_destruct();
+	return 0;
+}
@@ -46,7 +46,7 @@ void worker_with_scope(interactive_pool<Foo>* pool)
 			interactive_pool_time elapsedTime; // get elapsed time necessary to connect
 			interactive_pool_scoped_connection<Foo> c( pool, 2000, &elapsedTime );
 
-			cout << "Thread " << std::this_thread::get_id() << " got item in " << elapsedTime.elapsed_time.count() << " ms" << endl;
+			cout << "Thread " << std::this_thread::get_id() << " got item in " << std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime.elapsed_time).count() << " us" << endl;
 			c->Write();
 		}
 		catch (std::exception& e)
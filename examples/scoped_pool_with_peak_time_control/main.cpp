@@ -38,9 +38,9 @@ public:
 
 
 // Call back function instead lambda for this example
-void peak_alarm_function( const std::string& id, uint32_t trigger_level, uint32_t peak_alarm )
+void peak_alarm_function( const std::string& id, interactive_pool_duration trigger_level, interactive_pool_duration peak_alarm )
 {
-	cout << "Has triggered peak time to access pool " << peak_alarm << " ms." << " Reported by pool: " << id << endl;
+	cout << "Has triggered peak time to access pool " << std::chrono::duration_cast<std::chrono::milliseconds>(peak_alarm).count() << " ms." << " Reported by pool: " << id << endl;
 }
 
 
@@ -58,7 +58,7 @@ void worker_with_scope_peak_detector(interactive_pool< Foo > * pool)
 	//	-> id, same as constructor
 	//  -> trigger_level , same tha constructor
 	//	-> peak_alarm : value above the threshold
-	interactive_peak_detector<std::string> _peak ( string("Connection Pool 1"), 1300, &peak_alarm_function );
+	interactive_peak_detector<std::string> _peak ( string("Connection Pool 1"), std::chrono::milliseconds(1300), &peak_alarm_function );
 	
 	for (int i = 0; i < operations; i++)
 	{
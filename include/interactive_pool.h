@@ -14,256 +14,3194 @@
 #include <deque>
 
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include <chrono>
 #include <functional>
 #include <numeric>
 #include <thread>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <unordered_map>
+#include <map>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/// clock and resolution used by all the metrics of the pool
+// steady clock, it never goes backwards. Times are carried in nanoseconds from get_item() to the detectors
+typedef std::chrono::steady_clock interactive_pool_clock;
+typedef std::chrono::nanoseconds interactive_pool_duration;
 
 /// interactive_pool_time
 // structure use for metrics 
 typedef struct {
 
-	std::chrono::time_point<std::chrono::high_resolution_clock> init;
-	std::chrono::time_point<std::chrono::high_resolution_clock> finish;
-	std::chrono::milliseconds elapsed_time;
+	std::chrono::time_point<interactive_pool_clock> init;
+	std::chrono::time_point<interactive_pool_clock> finish;
+	interactive_pool_duration elapsed_time;
+
+} interactive_pool_time;
+
+
+/// base class for detectors
+typedef struct tag_base_detector { virtual void set_elapsed_time(const interactive_pool_duration&) = 0; } base_detector;
+
+
+// interactive_thread_index()
+// small number that identifies the calling thread, assigned in order of first use.
+// Used to spread the per thread counters of the metrics between shards
+inline size_t interactive_thread_index()
+{
+	static std::atomic<size_t> next(0);
+	thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed);
+	return index;
+}
+
+
+/// interactive_histogram_snapshot
+/// merged copy of an interactive_latency_histogram, taken at a given moment
+/// summary: all the queries (percentiles, max, mean) are done over this copy, out of the recording path
+struct interactive_histogram_snapshot
+{
+	std::vector<uint64_t> counts;	// samples of each bucket
+	uint64_t total = 0;				// number of samples
+	uint64_t sum = 0;				// sum of all samples, in nanoseconds
+	uint64_t max = 0;				// highest sample, in nanoseconds
+
+	// percentile()
+	// returns the value under which are the p percent of the samples (p from 0 to 100, ex. 99.9)
+	// the value is the upper limit of the bucket, with a relative error below 3%
+	interactive_pool_duration percentile(double p) const;
+
+	// mean of all samples
+	interactive_pool_duration mean() const
+	{
+		return interactive_pool_duration(total ? static_cast<interactive_pool_duration::rep>(sum / total) : 0);
+	}
+};
+
+
+/// interactive_latency_histogram
+/// lock free HDR style (log-linear) histogram of durations
+/// summary: every power of two is split in 32 linear buckets, so any value is kept with a relative error
+/// below 3% from 1 nanosecond to 18 minutes (longer values are counted in the last bucket).
+/// Each thread records in its own shard of counters (no contention, no allocation, a few relaxed atomic adds),
+/// the shards are merged when a snapshot is requested.
+class interactive_latency_histogram
+{public:
+	static const unsigned sub_bucket_bits = 5;
+	static const uint64_t sub_buckets = 1ull << sub_bucket_bits;
+	static const unsigned max_value_bits = 40;
+	static const size_t bucket_count = (max_value_bits - sub_bucket_bits + 1) * sub_buckets;
+	static const size_t shard_count = 8;
+
+	interactive_latency_histogram()
+		: _shards(new shard[shard_count])
+	{
+		reset();
+	}
+
+	// record()
+	// adds one sample, can be called from any thread
+	void record(const interactive_pool_duration& d)
+	{
+		uint64_t v = (d.count() > 0) ? static_cast<uint64_t>(d.count()) : 0;
+		shard& s = _shards[interactive_thread_index() % shard_count];
+		s.counts[bucket_of(v)].fetch_add(1, std::memory_order_relaxed);
+		s.sum.fetch_add(v, std::memory_order_relaxed);
+		uint64_t m = s.max.load(std::memory_order_relaxed);
+		while (v > m && !s.max.compare_exchange_weak(m, v, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	// snapshot()
+	// merges all shards in a copy that can be queried
+	interactive_histogram_snapshot snapshot() const
+	{
+		interactive_histogram_snapshot r;
+		r.counts.assign(bucket_count, 0);
+		for (size_t i = 0; i < shard_count; i++)
+		{
+			const shard& s = _shards[i];
+			for (size_t b = 0; b < bucket_count; b++)
+			{
+				uint64_t c = s.counts[b].load(std::memory_order_relaxed);
+				r.counts[b] += c;
+				r.total += c;
+			}
+			r.sum += s.sum.load(std::memory_order_relaxed);
+			r.max = std::max(r.max, s.max.load(std::memory_order_relaxed));
+		}
+		return r;
+	}
+
+	// reset()
+	// clears all samples. Samples recorded at the same time may be lost
+	void reset()
+	{
+		for (size_t i = 0; i < shard_count; i++)
+		{
+			shard& s = _shards[i];
+			for (size_t b = 0; b < bucket_count; b++)
+			{
+				s.counts[b].store(0, std::memory_order_relaxed);
+			}
+			s.sum.store(0, std::memory_order_relaxed);
+			s.max.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	// bucket_of()
+	// index of the bucket of a value in nanoseconds
+	static size_t bucket_of(uint64_t v)
+	{
+		if (v < sub_buckets)
+		{
+			return static_cast<size_t>(v);
+		}
+		unsigned msb = highest_bit(v);
+		if (msb >= max_value_bits)
+		{
+			return bucket_count - 1;
+		}
+		unsigned shift = msb - sub_bucket_bits;
+		return static_cast<size_t>((shift + 1) * sub_buckets + ((v >> shift) - sub_buckets));
+	}
+
+	// bucket_upper()
+	// highest value, in nanoseconds, counted in a bucket
+	static uint64_t bucket_upper(size_t b)
+	{
+		if (b < sub_buckets)
+		{
+			return b;
+		}
+		uint64_t shift = b / sub_buckets - 1;
+		uint64_t base = (sub_buckets + b % sub_buckets) << shift;
+		return base + ((1ull << shift) - 1);
+	}
+
+private:
+	static unsigned highest_bit(uint64_t v)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return 63 - static_cast<unsigned>(__builtin_clzll(v));
+#else
+		unsigned r = 0;
+		while (v >>= 1)
+		{
+			r++;
+		}
+		return r;
+#endif
+	}
+
+	struct shard
+	{
+		std::atomic<uint64_t> counts[bucket_count];
+		std::atomic<uint64_t> sum;
+		std::atomic<uint64_t> max;
+	};
+
+	std::unique_ptr< shard[] > _shards;
+};
+
+inline interactive_pool_duration interactive_histogram_snapshot::percentile(double p) const
+{
+	if (total == 0)
+	{
+		return interactive_pool_duration(0);
+	}
+	uint64_t rank = static_cast<uint64_t>(std::ceil((p / 100.0) * static_cast<double>(total)));
+	rank = std::max<uint64_t>(1, std::min(rank, total));
+	uint64_t seen = 0;
+	for (size_t b = 0; b < counts.size(); b++)
+	{
+		seen += counts[b];
+		if (seen >= rank)
+		{
+			// never report more than the real maximum
+			return interactive_pool_duration(static_cast<interactive_pool_duration::rep>(std::min(interactive_latency_histogram::bucket_upper(b), max)));
+		}
+	}
+	return interactive_pool_duration(static_cast<interactive_pool_duration::rep>(max));
+}
+
+
+/// interactive_trace_event
+/// one event of an interactive_event_trace, see interactive_pool::enable_event_trace()
+enum interactive_trace_type : uint8_t
+{
+	interactive_trace_acquire_start = 0,	// get_item() / try_get_item() called
+	interactive_trace_acquire_end,			// get_item() / try_get_item() got an item
+	interactive_trace_validate,				// an item was rejected by the validator or the test function
+	interactive_trace_release,				// item given back with set_item()
+	interactive_trace_timeout,				// get_item() ended without item
+	interactive_trace_discard,				// item given back with discard()
+	interactive_trace_no_item				// try_get_item() ended without item
+};
+
+typedef struct {
+
+	uint64_t timestamp;		// steady clock, nanoseconds since its epoch
+	const void* item;		// address of the item, nullptr for acquire_start and timeout
+	uint32_t thread;		// interactive_thread_index() of the caller
+	interactive_trace_type type;
+
+} interactive_trace_event;
+
+
+/// interactive_event_trace
+/// lock free ring buffers of the last events of a pool, made to debug stalls without changing the timing
+/// summary: each thread writes in its own ring (threads beyond shard_count share them), an event is a
+/// timestamp and a few words stored with relaxed atomics, no lock and no allocation. When a ring is full
+/// the oldest events are overwritten. snapshot() copies the complete events of all rings, ordered by time
+class interactive_event_trace
+{public:
+	static const size_t shard_count = 16;
+
+	// events_per_thread is rounded up to a power of two
+	explicit interactive_event_trace(size_t events_per_thread = 4096)
+		: _size(1)
+	{
+		while (_size < events_per_thread)
+		{
+			_size <<= 1;
+		}
+		_shards.reset(new shard[shard_count]);
+		for (size_t i = 0; i < shard_count; i++)
+		{
+			_shards[i].head.store(0, std::memory_order_relaxed);
+			_shards[i].events.reset(new slot[_size]);
+			for (size_t e = 0; e < _size; e++)
+			{
+				_shards[i].events[e].seq.store(0, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// record()
+	// adds one event, can be called from any thread
+	void record(interactive_trace_type type, const void* item)
+	{
+		uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<interactive_pool_duration>(interactive_pool_clock::now().time_since_epoch()).count());
+		uint32_t thread = static_cast<uint32_t>(interactive_thread_index());
+		shard& s = _shards[thread % shard_count];
+		uint64_t n = s.head.fetch_add(1, std::memory_order_relaxed);
+		slot& e = s.events[n & (_size - 1)];
+		// the sequence tells the readers that the slot is being written
+		e.seq.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		e.timestamp.store(now, std::memory_order_relaxed);
+		e.item.store(item, std::memory_order_relaxed);
+		e.info.store((static_cast<uint64_t>(thread) << 8) | type, std::memory_order_relaxed);
+		e.seq.store(n + 1, std::memory_order_release);
+	}
+
+	// snapshot()
+	// returns the events kept in the rings, older first. Events being written at the same time are skipped
+	std::vector< interactive_trace_event > snapshot() const
+	{
+		std::vector< interactive_trace_event > r;
+		for (size_t i = 0; i < shard_count; i++)
+		{
+			const shard& s = _shards[i];
+			for (size_t e = 0; e < _size; e++)
+			{
+				const slot& x = s.events[e];
+				uint64_t seq = x.seq.load(std::memory_order_acquire);
+				if (seq == 0)
+				{
+					continue;
+				}
+				interactive_trace_event v;
+				v.timestamp = x.timestamp.load(std::memory_order_relaxed);
+				v.item = x.item.load(std::memory_order_relaxed);
+				uint64_t info = x.info.load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (x.seq.load(std::memory_order_relaxed) != seq)
+				{
+					continue;
+				}
+				v.thread = static_cast<uint32_t>(info >> 8);
+				v.type = static_cast<interactive_trace_type>(info & 0xff);
+				r.push_back(v);
+			}
+		}
+		std::stable_sort(r.begin(), r.end(), [](const interactive_trace_event& a, const interactive_trace_event& b) { return a.timestamp < b.timestamp; });
+		return r;
+	}
+
+private:
+	struct slot
+	{
+		std::atomic<uint64_t> seq;		// 0 while empty or being written, else position + 1
+		std::atomic<uint64_t> timestamp;
+		std::atomic<const void*> item;
+		std::atomic<uint64_t> info;		// thread << 8 | type
+	};
+
+	struct shard
+	{
+		std::atomic<uint64_t> head;
+		std::unique_ptr< slot[] > events;
+	};
+
+	size_t _size;
+	std::unique_ptr< shard[] > _shards;
+};
+
+
+// interactive_write_chrome_trace()
+// writes the events as Chrome trace_event JSON, to open with chrome://tracing or https://ui.perfetto.dev
+// the waits of get_item() are shown as slices in the row of each thread, the time each item is held
+// as async slices (one row per item), the rest as instant events
+inline void interactive_write_chrome_trace(std::ostream& out, const std::vector< interactive_trace_event >& events)
+{
+	static const char* const names[] = { "acquire", "acquire", "validate failed", "release", "timeout", "discard", "no free item" };
+	// acquisitions open in each thread, an end without start (its start was overwritten in the ring) is shown as an instant event
+	std::unordered_map< uint32_t, size_t > open;
+	out << "{\"traceEvents\":[";
+	const char* separator = "\n";
+	std::ostringstream ts;
+	ts.setf(std::ios::fixed);
+	ts.precision(3);
+	for (const interactive_trace_event& e : events)
+	{
+		ts.str("");
+		ts << static_cast<double>(e.timestamp) / 1000.0;
+		const std::string common = "\"pid\":1,\"tid\":" + std::to_string(e.thread) + ",\"ts\":" + ts.str();
+		char item[32];
+		snprintf(item, sizeof(item), "\"0x%llx\"", static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(e.item)));
+		switch (e.type)
+		{
+		case interactive_trace_acquire_start:
+			open[e.thread]++;
+			out << separator << "{\"name\":\"acquire\",\"cat\":\"pool\",\"ph\":\"B\"," << common << "}";
+			break;
+		case interactive_trace_acquire_end:
+			if (open[e.thread] > 0)
+			{
+				open[e.thread]--;
+				out << separator << "{\"name\":\"acquire\",\"cat\":\"pool\",\"ph\":\"E\"," << common << ",\"args\":{\"item\":" << item << "}}";
+			}
+			else
+			{
+				out << separator << "{\"name\":\"acquire\",\"cat\":\"pool\",\"ph\":\"i\",\"s\":\"t\"," << common << ",\"args\":{\"item\":" << item << "}}";
+			}
+			out << ",\n{\"name\":\"hold\",\"cat\":\"pool\",\"ph\":\"b\",\"id\":" << item << "," << common << "}";
+			break;
+		case interactive_trace_timeout:
+		case interactive_trace_no_item:
+			if (open[e.thread] > 0)
+			{
+				open[e.thread]--;
+				out << separator << "{\"name\":\"acquire\",\"cat\":\"pool\",\"ph\":\"E\"," << common << "}";
+				out << ",\n";
+			}
+			else
+			{
+				out << separator;
+			}
+			out << "{\"name\":\"" << names[e.type] << "\",\"cat\":\"pool\",\"ph\":\"i\",\"s\":\"t\"," << common << "}";
+			break;
+		case interactive_trace_release:
+		case interactive_trace_discard:
+			out << separator << "{\"name\":\"hold\",\"cat\":\"pool\",\"ph\":\"e\",\"id\":" << item << "," << common << "}";
+			out << ",\n{\"name\":\"" << names[e.type] << "\",\"cat\":\"pool\",\"ph\":\"i\",\"s\":\"t\"," << common << ",\"args\":{\"item\":" << item << "}}";
+			break;
+		default:
+			out << separator << "{\"name\":\"" << names[e.type] << "\",\"cat\":\"pool\",\"ph\":\"i\",\"s\":\"t\"," << common << ",\"args\":{\"item\":" << item << "}}";
+			break;
+		}
+		separator = ",\n";
+	}
+	out << "\n]}\n";
+}
+
+
+/// interactive_pool_stats
+/// snapshot of the counters of a pool, see interactive_pool::stats()
+/// summary: the counters are read one by one without lock, so while the pool is in use
+/// the values may not match exactly between them (ex. free + in_use vs total)
+typedef struct {
+
+	uint64_t total;					// items of the pool: free, in use and being reset or replaced
+	uint64_t free;					// items ready to be used
+	uint64_t in_use;				// items held by callers
+	uint64_t waiters;				// callers waiting for an item right now
+	uint64_t acquires;				// items given by get_item() / try_get_item()
+	uint64_t timeouts;				// get_item() calls that ended without item
+	uint64_t validation_failures;	// items rejected by the validator or the test function
+	uint64_t created;				// items created (initial ones and replacements)
+	uint64_t destroyed;				// items destroyed by discard()
+	uint64_t peak_in_use;			// highest in_use seen
+	interactive_pool_duration wait_time;	// total time waited by get_item() (only timed or waiting calls are measured)
+	interactive_pool_duration hold_time;	// total hold time of the released items (needs enable_hold_tracking())
+
+	// pool lock, only filled when the LockPolicy is interactive_instrumented_lock
+	uint64_t lock_acquisitions;				// times the lock was taken
+	uint64_t lock_contended;				// times the lock was busy (try_lock failed first)
+	interactive_pool_duration lock_wait_time;	// total time waiting for the lock
+	interactive_pool_duration lock_hold_time;	// total time the lock was held
+	interactive_pool_duration lock_max_hold;	// longest critical section
+
+} interactive_pool_stats;
+
+
+/// interactive_pool_lease_info
+/// an item that is out of the pool, see interactive_pool::outstanding_leases()
+typedef struct {
+
+	const void* item;								// address of the item
+	std::thread::id owner;							// thread that got the item
+	interactive_pool_clock::time_point checkout;	// when it was given
+	interactive_pool_duration held;					// time it has been out
+	const char* tag;								// caller tag, see interactive_pool::tag_item(), or nullptr
+
+} interactive_pool_lease_info;
+
+
+/// interactive_pool policies
+/// compile time options of interactive_pool. They are resolved at compile time so the calls are inlined
+/// and the features that are not used compile to nothing. The defaults keep the classic behaviour.
+
+/// LockPolicy : any type with lock(), try_lock() and unlock(). Default std::mutex
+/// interactive_spin_lock, for very short critical sections, spins instead of sleeping in the kernel
+class interactive_spin_lock
+{public:
+	interactive_spin_lock() : _flag(false) {}
+	void lock()
+	{
+		while (_flag.exchange(true, std::memory_order_acquire))
+		{
+			std::this_thread::yield();
+		}
+	}
+	bool try_lock() { return !_flag.exchange(true, std::memory_order_acquire); }
+	void unlock() { _flag.store(false, std::memory_order_release); }
+private:
+	std::atomic<bool> _flag;
+};
+
+/// interactive_null_lock, no locking at all. Only for pools used by a single thread
+/// (do not use it with background reset or discard(), they use an internal thread)
+class interactive_null_lock
+{public:
+	void lock() {}
+	bool try_lock() { return true; }
+	void unlock() {}
+};
+
+/// interactive_instrumented_lock, wraps another lock (std::mutex by default) and measures it: how many times it was
+/// busy when requested, the time spent waiting for it, the time it was held and the longest critical section.
+/// The results are shown by interactive_pool::stats(). It reads the clock twice per lock, use it to decide, with data,
+/// if the pool needs to be split (ex. interactive_numa_pool or interactive_keyed_pool)
+template <class Mutex = std::mutex> class interactive_instrumented_lock
+{public:
+	interactive_instrumented_lock()
+		: _acquisitions(0), _contended(0), _waitNs(0), _holdNs(0), _maxHoldNs(0)
+	{}
+
+	void lock()
+	{
+		if (!_m.try_lock())
+		{
+			_contended.fetch_add(1, std::memory_order_relaxed);
+			interactive_pool_clock::time_point t0 = interactive_pool_clock::now();
+			_m.lock();
+			_since = interactive_pool_clock::now();
+			_waitNs.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<interactive_pool_duration>(_since - t0).count()), std::memory_order_relaxed);
+		}
+		else
+		{
+			_since = interactive_pool_clock::now();
+		}
+		_acquisitions.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool try_lock()
+	{
+		if (!_m.try_lock())
+		{
+			return false;
+		}
+		_since = interactive_pool_clock::now();
+		_acquisitions.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	void unlock()
+	{
+		uint64_t held = static_cast<uint64_t>(std::chrono::duration_cast<interactive_pool_duration>(interactive_pool_clock::now() - _since).count());
+		_m.unlock();
+		_holdNs.fetch_add(held, std::memory_order_relaxed);
+		uint64_t m = _maxHoldNs.load(std::memory_order_relaxed);
+		while (held > m && !_maxHoldNs.compare_exchange_weak(m, held, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	// read()
+	// copies the counters to the lock fields of a stats snapshot
+	void read(interactive_pool_stats& s) const
+	{
+		s.lock_acquisitions = _acquisitions.load(std::memory_order_relaxed);
+		s.lock_contended = _contended.load(std::memory_order_relaxed);
+		s.lock_wait_time = interactive_pool_duration(static_cast<interactive_pool_duration::rep>(_waitNs.load(std::memory_order_relaxed)));
+		s.lock_hold_time = interactive_pool_duration(static_cast<interactive_pool_duration::rep>(_holdNs.load(std::memory_order_relaxed)));
+		s.lock_max_hold = interactive_pool_duration(static_cast<interactive_pool_duration::rep>(_maxHoldNs.load(std::memory_order_relaxed)));
+	}
+
+private:
+	Mutex _m;
+	interactive_pool_clock::time_point _since;	// written only by the owner of the lock
+	std::atomic<uint64_t> _acquisitions;
+	std::atomic<uint64_t> _contended;
+	std::atomic<uint64_t> _waitNs;
+	std::atomic<uint64_t> _holdNs;
+	std::atomic<uint64_t> _maxHoldNs;
+};
+
+// reads the lock counters into the stats, nothing to read for the not instrumented locks
+template <class L> inline void interactive_read_lock_stats(const L&, interactive_pool_stats&) {}
+template <class M> inline void interactive_read_lock_stats(const interactive_instrumented_lock<M>& l, interactive_pool_stats& s) { l.read(s); }
+
+/// OrderPolicy : which free item is given first. Released items are always pushed at the back
+/// interactive_fifo_order, the oldest free item (default), rotates the use of all items
+struct interactive_fifo_order
+{
+	template <class C> static typename C::value_type take(C& c)
+	{
+		typename C::value_type j = std::move(c.front());
+		c.pop_front();
+		return j;
+	}
+};
+
+/// interactive_lifo_order, the last released item, its memory is usually still in the cache
+struct interactive_lifo_order
+{
+	template <class C> static typename C::value_type take(C& c)
+	{
+		typename C::value_type j = std::move(c.back());
+		c.pop_back();
+		return j;
+	}
+};
+
+/// ValidatorPolicy : functor bool(item&) called on every item before it is returned by get_item(),
+/// besides the function given in each call. Same meaning as that function.
+/// interactive_no_validator, accepts all items (default)
+struct interactive_no_validator
+{
+	template <class I> bool operator()(I&) const { return true; }
+};
+
+/// MetricsPolicy : detector fed by the pool with the time of every acquisition (any class with set_elapsed_time).
+/// It is called from all the threads that use the pool, without lock. It is kept by value in the pool,
+/// the detectors can not be copied so they are attached with interactive_metrics_ref.
+/// interactive_no_metrics, no pool level metrics (default), no time is taken for it
+struct interactive_no_metrics
+{
+	void set_elapsed_time(const interactive_pool_duration&) {}
+};
+
+/// interactive_metrics_ref, feeds a detector owned by the caller, that must outlive the pool
+/// and be thread safe (ex. interactive_shared_peak_detector, interactive_ewma_detector)
+/// ex. interactive_pool<Foo, std::mutex, interactive_fifo_order, interactive_no_validator,
+///                      interactive_metrics_ref<interactive_shared_peak_detector<int>>> pool(4, {}, peak);
+template <class D> struct interactive_metrics_ref
+{
+	interactive_metrics_ref(D& detector) : _detector(&detector) {}
+	void set_elapsed_time(const interactive_pool_duration& t) { _detector->set_elapsed_time(t); }
+
+private:
+	D* _detector;
+};
+
+// true when the MetricsPolicy needs the acquisition time
+template <class M> struct interactive_metrics_enabled : std::true_type {};
+template <> struct interactive_metrics_enabled<interactive_no_metrics> : std::false_type {};
+
+// tells if an optional test function was given, std::function can be empty, any other callable is always set
+template <class F> inline bool interactive_is_set(const F&) { return true; }
+template <class R, class... A> inline bool interactive_is_set(const std::function<R(A...)>& f) { return static_cast<bool>(f); }
+
+
+/// interactive_pool
+/// main class , created on 2026-06-20 
+/// author <roni.gonzalez@interconetica.com>
+/// summary: interactive_pool try yop be a template class that manages a simple pool of resources
+/// giving an option of monitoring the pool load 
+/// The policies (see above) are optional, interactive_pool<T> is the classic pool
+template <class T
+	, class LockPolicy = std::mutex
+	, class OrderPolicy = interactive_fifo_order
+	, class ValidatorPolicy = interactive_no_validator
+	, class MetricsPolicy = interactive_no_metrics
+> class  interactive_pool
+{
+public:
+	// defines a pool's item
+	typedef  std::unique_ptr< T > item;
+	// defines the function used to clean an item before it can be reused
+	typedef std::function<void(T&)> reset_function;
+
+	// Constructor 
+	// size : number of resournces (initial buffer size)
+	// reset : optional function called on each released item to leave it ready for the next caller
+	// background_reset : when true, reset is called from an internal thread instead of the caller of set_item()
+	interactive_pool(size_t size, reset_function reset = {}, bool background_reset = false)
+		: interactive_pool(size, ValidatorPolicy(), MetricsPolicy(), reset, background_reset)
+	{}
+
+	// Constructor with policy instances, for validators or detectors that have state
+	// validator : instance of ValidatorPolicy
+	// metrics : instance of MetricsPolicy (ex. interactive_metrics_ref of a detector)
+	interactive_pool(size_t size, ValidatorPolicy validator, MetricsPolicy metrics, reset_function reset = {}, bool background_reset = false)
+		: _initialSize(size)
+		, _validator(validator)
+		, _metrics(metrics)
+		, _reset(reset)
+		, _backgroundReset(background_reset && reset)
+		, _resetting(0)
+		, _replacing(0)
+		, _stop(false)
+		, _affinity(false)
+		, _affinityHits(0)
+		, _affinityMisses(0)
+		, _acquireHistogram(nullptr)
+		, _holdTracking(false)
+		, _leaseRegistry(false)
+		, _holdHistogram(nullptr)
+		, _holdDetector(nullptr)
+		, _acquireDetector(nullptr)
+		, _eventTrace(nullptr)
+	{
+		_freeItems.resize(size);
+		std::for_each(_freeItems.begin(), _freeItems.end(), [](item& i) {i = std::move(std::make_unique<T>()); });
+		std::for_each(_freeItems.begin(), _freeItems.end(), [this](item& i) {register_item(i.get()); });
+		_counters.created.store(size, std::memory_order_relaxed);
+		_counters.free.store(size, std::memory_order_relaxed);
+
+		if (_backgroundReset)
+		{
+			_maintenance = std::thread(&interactive_pool::maintenance, this);
+		}
+	}
+
+	//check_before_destruct()
+	// can be called before destruct the pool, detect if exists a size difference between initial size and current size
+	// Throws a exception if some element is not released
+	// * Never calls directly in your destructor. Check the examples to see how to use it.
+	void check_before_destruct()
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+		// items waiting for the background reset still belong to the pool
+		// and also the ones being replaced
+		size_t current = _freeItems.size() + _dirtyItems.size() + _resetting + _replacing;
+		if (current != _initialSize)
+		{
+			// with the lease registry enabled, tell who holds the missing items
+			std::ostringstream leases;
+			interactive_pool_clock::time_point now = interactive_pool_clock::now();
+			for (const lease_slot& s : _slots)
+			{
+				if (s.out)
+				{
+					leases << " [thread " << s.owner << " for "
+						<< std::chrono::duration_cast<std::chrono::milliseconds>(now - s.checkout).count() << " ms"
+						<< (s.tag ? std::string(", ") + s.tag : std::string()) << "]";
+				}
+			}
+			throw std::runtime_error(std::string(std::string("interactive_pool: Different count of items. Pool was created with [") + std::to_string(_initialSize) + std::string("] but during destruction have [") + std::to_string(current) + std::string("]")) + (leases.str().empty() ? std::string() : std::string(". Outstanding:") + leases.str()));
+		}
+	}
+
+	// Destructor
+	// releases all items
+	virtual ~interactive_pool()
+	{
+		if (_maintenance.joinable())
+		{
+			{
+				std::lock_guard<LockPolicy> l(_lock);
+				_stop = true;
+			}
+			_maintenanceCv.notify_one();
+			_maintenance.join();
+		}
+		_dirtyItems.clear();
+		_discardedItems.clear();
+		std::for_each(_freeItems.begin(), _freeItems.end(), [](item& i) {i.reset(); });
+		_freeItems.clear();
+	}
+
+
+	// get_item()
+	// returns a item to caller or throw an exception if pool is empty
+	// max_wait_ms		: maximun time, in milliseconds, to wait a free instance.  Once this time has elapsed, an exception will be thrown
+	//					  special values: 
+	//							0 -> try just once.
+	//							Default = numeric_limits<uint32_t>::max()
+	// time_elapsed_ms 	: Time it took to get an instance from the thread pool (nanoseconds resolution)
+	// f				: optional test / initialize function bool(item&). Any callable (ex. a lambda) is inlined,
+	//					  a std::function is also accepted
+	template <class F = std::function<bool(item&)> >
+	item get_item(uint32_t max_wait_ms = std::numeric_limits<uint32_t>::max(), interactive_pool_time* time_elapsed_ms = nullptr, F f = F() )
+	{
+		item j;
+		interactive_latency_histogram* histogram = _acquireHistogram.load(std::memory_order_acquire);
+		base_detector* detector = _acquireDetector.load(std::memory_order_acquire);
+		trace_event(interactive_trace_acquire_start, nullptr);
+
+		if (!time_elapsed_ms && !interactive_metrics_enabled<MetricsPolicy>::value && !histogram && !detector)
+		{
+			// fast path, no metric is requested: the first attempt does not read any clock
+			if (take_item(j, f))
+			{
+				return j;
+			}
+			if (max_wait_ms == 0)
+			{
+				_counters.timeouts.fetch_add(1, std::memory_order_relaxed);
+				trace_event(interactive_trace_timeout, nullptr);
+				throw std::runtime_error("interactive_pool: All items are in use");
+			}
+		}
+
+		// counts the caller as a waiter while it is sleeping
+		struct waiter_guard
+		{
+			std::atomic<uint64_t>* c = nullptr;
+			~waiter_guard() { if (c) c->fetch_sub(1, std::memory_order_relaxed); }
+		} waiter;
+
+		const bool b_timed = (time_elapsed_ms != nullptr) || interactive_metrics_enabled<MetricsPolicy>::value || histogram || detector;
+		interactive_pool_time pool_time;
+		if (!time_elapsed_ms)
+		{
+			// the pool metrics (or the timeout) need the time even if the caller did not request it
+			time_elapsed_ms = &pool_time;
+		}
+
+		// get initial time point
+		time_elapsed_ms->init = interactive_pool_clock::now();
+		const bool b_forever = (max_wait_ms == std::numeric_limits<uint32_t>::max());
+		std::chrono::duration<double, std::milli> elapsed(0);
+
+		do
+		{
+			if (take_item(j, f))
+			{
+				if (b_timed || waiter.c)
+				{
+					// if metric is requested (or the caller had to wait), calculate elapsed time
+					time_elapsed_ms->finish = interactive_pool_clock::now();
+					time_elapsed_ms->elapsed_time = std::chrono::duration_cast<interactive_pool_duration>(time_elapsed_ms->finish - time_elapsed_ms->init);
+					_counters.wait_ns.fetch_add(static_cast<uint64_t>(time_elapsed_ms->elapsed_time.count()), std::memory_order_relaxed);
+					if (interactive_metrics_enabled<MetricsPolicy>::value)
+					{
+						_metrics.set_elapsed_time(time_elapsed_ms->elapsed_time);
+					}
+					if (histogram)
+					{
+						histogram->record(time_elapsed_ms->elapsed_time);
+					}
+					if (detector)
+					{
+						detector->set_elapsed_time(time_elapsed_ms->elapsed_time);
+					}
+				}
+				// return item
+				return j;
+			}
+
+			if (max_wait_ms == 0)
+			{
+				// try just once, no need to wait
+				break;
+			}
+
+			// not items available, wait till timeout (the clock is not needed when waiting forever)
+			if (!b_forever)
+			{
+				elapsed = (interactive_pool_clock::now() - time_elapsed_ms->init);
+			}
+			if (!waiter.c)
+			{
+				waiter.c = &_counters.waiters;
+				waiter.c->fetch_add(1, std::memory_order_relaxed);
+			}
+			// rest a little 
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		} while (b_forever || elapsed.count() < max_wait_ms);
+
+		// no free items
+		_counters.timeouts.fetch_add(1, std::memory_order_relaxed);
+		trace_event(interactive_trace_timeout, nullptr);
+		throw std::runtime_error("interactive_pool: All items are in use");
+	}
+
+	// try_get_item()
+	// single attempt to get a free item, never waits and never throws
+	// r	: receives the item when the function returns true
+	// f	: optional test / initialize function, same as in get_item()
+	template <class F = std::function<bool(item&)> >
+	bool try_get_item(item& r, const F& f = F())
+	{
+		trace_event(interactive_trace_acquire_start, nullptr);
+		if (take_item(r, f))
+		{
+			return true;
+		}
+		trace_event(interactive_trace_no_item, nullptr);
+		return false;
+	}
+
+private:
+	// take_item()
+	// single attempt of get_item() and try_get_item()
+	template <class F>
+	bool take_item(item& r, const F& f)
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+
+		if (!_freeItems.empty())
+		{
+			// got at least 1 item, reuturn it and remove from pool
+			item j = pop_free_item();
+			// policy validator, then the check or initialize function if it is defined
+			bool b_status_ok = _validator(j);
+			if( b_status_ok && interactive_is_set(f) )
+			{
+				b_status_ok = f(j) ;
+			}
+
+			// status ok, return item
+			if(b_status_ok)
+			{
+				if (tracking_checkouts())
+				{
+					checkout(j.get());
+				}
+				item_out();
+				trace_event(interactive_trace_acquire_end, j.get());
+				r = std::move(j);
+				return true;
+			}
+			else
+			{
+				_counters.validation_failures.fetch_add(1, std::memory_order_relaxed);
+				trace_event(interactive_trace_validate, j.get());
+				push_free_item(std::move(j));
+			}
+		}
+		return false;
+	}
+
+public:
+	// set_thread_affinity()
+	// when enabled, get_item() returns to each thread the last item it released, if it is still free,
+	// keeping its memory warm in the cache of that core. Otherwise the usual order is used.
+	// Only the last few released items are candidates, so the lookup does not grow with the pool
+	void set_thread_affinity(bool enable)
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+		_affinity = enable;
+		// one slot per thread index, threads beyond affinity_slots share them (it is only a hint)
+		_lastItem.assign(enable ? affinity_slots : 0, nullptr);
+	}
+
+	// get_affinity_hits() / get_affinity_misses()
+	// number of acquisitions that got / did not get the previous item of the thread while affinity is enabled
+	uint64_t get_affinity_hits() const
+	{
+		return _affinityHits.load(std::memory_order_relaxed);
+	}
+	uint64_t get_affinity_misses() const
+	{
+		return _affinityMisses.load(std::memory_order_relaxed);
+	}
+
+	// discard()
+	// use it instead of set_item() when the item is broken. The item is destroyed and a new one
+	// is created to take its place, both in the internal thread of the pool so the caller never waits
+	void discard(item& r)
+	{
+		interactive_pool_duration held(0);
+		bool b_held = false;
+		base_detector* detector = nullptr;
+		{
+			std::lock_guard<LockPolicy> l(_lock);
+			if (tracking_checkouts())
+			{
+				b_held = checkin(r.get(), interactive_pool_clock::now(), held);
+				detector = _holdDetector;
+			}
+			unregister_item(r.get());
+			trace_event(interactive_trace_discard, r.get());
+			_discardedItems.push_back(std::move(r));
+			_replacing++;
+			_counters.in_use.fetch_sub(1, std::memory_order_relaxed);
+			if (!_maintenance.joinable())
+			{
+				_maintenance = std::thread(&interactive_pool::maintenance, this);
+			}
+		}
+		_maintenanceCv.notify_one();
+
+		if (b_held)
+		{
+			hold_finished(held, detector);
+		}
+	}
+
+	// enable_acquire_histogram()
+	// starts to keep a histogram of the time taken by every get_item(), see interactive_latency_histogram.
+	// Recording does not take the lock nor allocate. Once enabled it can not be disabled
+	void enable_acquire_histogram()
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+		if (!_acquireHistogramOwner)
+		{
+			_acquireHistogramOwner.reset(new interactive_latency_histogram());
+			_acquireHistogram.store(_acquireHistogramOwner.get(), std::memory_order_release);
+		}
+	}
+
+	// acquire_histogram()
+	// returns a snapshot of the acquisition times (empty if the histogram is not enabled)
+	// ex. pool.acquire_histogram().percentile(99.9)
+	interactive_histogram_snapshot acquire_histogram() const
+	{
+		interactive_latency_histogram* h = _acquireHistogram.load(std::memory_order_acquire);
+		return h ? h->snapshot() : interactive_histogram_snapshot();
+	}
+
+	// enable_hold_tracking()
+	// starts to timestamp every checkout and to measure how long the callers hold the items,
+	// until set_item(), discard() or the end of the scoped handler / lease.
+	// The hold times go to a histogram (see hold_histogram()) and to the hold detector, if any.
+	// Items that are already out when it is enabled are not measured
+	void enable_hold_tracking()
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+		if (!_holdHistogramOwner)
+		{
+			_holdHistogramOwner.reset(new interactive_latency_histogram());
+			_holdHistogram.store(_holdHistogramOwner.get(), std::memory_order_release);
+		}
+		_holdTracking.store(true, std::memory_order_relaxed);
+	}
+
+	// enable_lease_registry()
+	// starts to record, for each item given to a caller, the owner thread, the checkout time and an optional tag
+	// (see tag_item()). Uses the fixed slots of the items, nothing is allocated per acquisition.
+	// The outstanding leases can be read with outstanding_leases() and are listed by check_before_destruct()
+	void enable_lease_registry()
+	{
+		_leaseRegistry.store(true, std::memory_order_relaxed);
+	}
+
+	// tag_item()
+	// attaches a caller tag to an item that is out (ex. __FUNCTION__ or a request id).
+	// Only the pointer is kept, the text must live until the item is released (string literals are fine)
+	void tag_item(const item& r, const char* tag)
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+		auto it = _slotOf.find(r.get());
+		if (it != _slotOf.end() && _slots[it->second].out)
+		{
+			_slots[it->second].tag = tag;
+		}
+	}
+
+	// outstanding_leases()
+	// returns the items that are out right now, with their owner, checkout time and tag
+	std::vector< interactive_pool_lease_info > outstanding_leases()
+	{
+		std::vector< interactive_pool_lease_info > r;
+		interactive_pool_clock::time_point now = interactive_pool_clock::now();
+		std::lock_guard<LockPolicy> l(_lock);
+		for (const auto& p : _slotOf)
+		{
+			const lease_slot& s = _slots[p.second];
+			if (s.out)
+			{
+				interactive_pool_lease_info i;
+				i.item = p.first;
+				i.owner = s.owner;
+				i.checkout = s.checkout;
+				i.held = std::chrono::duration_cast<interactive_pool_duration>(now - s.checkout);
+				i.tag = s.tag;
+				r.push_back(i);
+			}
+		}
+		return r;
+	}
+
+	// set_acquire_detector()
+	// detector called with the time taken by every get_item() of every thread, nullptr to remove it.
+	// Use a thread safe detector (ex. interactive_shared_average_detector) if the pool is shared.
+	// The detector must outlive the pool or be removed before it is destroyed
+	void set_acquire_detector(base_detector* detector)
+	{
+		_acquireDetector.store(detector, std::memory_order_release);
+	}
+
+	// set_hold_detector()
+	// detector called with the hold time of each released item (needs enable_hold_tracking()).
+	// It is called from the threads that release the items, use a thread safe detector if the pool is shared
+	void set_hold_detector(base_detector* detector)
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+		_holdDetector = detector;
+	}
+
+	// hold_histogram()
+	// returns a snapshot of the hold times (empty if hold tracking is not enabled)
+	interactive_histogram_snapshot hold_histogram() const
+	{
+		interactive_latency_histogram* h = _holdHistogram.load(std::memory_order_acquire);
+		return h ? h->snapshot() : interactive_histogram_snapshot();
+	}
+
+	// enable_event_trace()
+	// starts to record the acquisitions, releases, timeouts, rejected and discarded items in lock free
+	// ring buffers that keep the last events_per_thread events of each thread (see interactive_event_trace).
+	// Once enabled it can not be disabled, calling it again does nothing
+	void enable_event_trace(size_t events_per_thread = 4096)
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+		if (!_eventTraceOwner)
+		{
+			_eventTraceOwner.reset(new interactive_event_trace(events_per_thread));
+			_eventTrace.store(_eventTraceOwner.get(), std::memory_order_release);
+		}
+	}
+
+	// event_trace()
+	// returns the recorded events, older first (empty if the trace is not enabled).
+	// ex. interactive_write_chrome_trace(file, pool.event_trace())
+	std::vector< interactive_trace_event > event_trace() const
+	{
+		interactive_event_trace* t = _eventTrace.load(std::memory_order_acquire);
+		return t ? t->snapshot() : std::vector< interactive_trace_event >();
+	}
+
+	// stats()
+	// returns a snapshot of the pool counters. It does not take the lock, so it can be called
+	// very often (ex. every second from a monitor) without disturbing the users of the pool
+	interactive_pool_stats stats() const
+	{
+		interactive_pool_stats r;
+		r.created = _counters.created.load(std::memory_order_relaxed);
+		r.destroyed = _counters.destroyed.load(std::memory_order_relaxed);
+		r.free = _counters.free.load(std::memory_order_relaxed);
+		r.in_use = _counters.in_use.load(std::memory_order_relaxed);
+		r.total = r.created - r.destroyed;
+		r.waiters = _counters.waiters.load(std::memory_order_relaxed);
+		r.acquires = _counters.acquires.load(std::memory_order_relaxed);
+		r.timeouts = _counters.timeouts.load(std::memory_order_relaxed);
+		r.validation_failures = _counters.validation_failures.load(std::memory_order_relaxed);
+		r.peak_in_use = _counters.peak_in_use.load(std::memory_order_relaxed);
+		r.wait_time = interactive_pool_duration(static_cast<interactive_pool_duration::rep>(_counters.wait_ns.load(std::memory_order_relaxed)));
+		r.hold_time = interactive_pool_duration(static_cast<interactive_pool_duration::rep>(_counters.hold_ns.load(std::memory_order_relaxed)));
+		r.lock_acquisitions = 0;
+		r.lock_contended = 0;
+		r.lock_wait_time = r.lock_hold_time = r.lock_max_hold = interactive_pool_duration(0);
+		interactive_read_lock_stats(_lock, r);
+		return r;
+	}
+
+	// get_available_count()
+	// returns the number of free items in the pool
+	size_t get_available_count()
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+		return _freeItems.size();
+	}
+
+	// owns()
+	// returns true when the item was created by this pool and has not been discarded
+	bool owns(const T* p)
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+		return _slotOf.find(p) != _slotOf.end();
+	}
+
+	// for_each_free_item()
+	// calls f(const T*) with each free item, under the lock of the pool. The items are not taken,
+	// so nothing is counted as an acquisition. f must not call the pool
+	template <class F>
+	void for_each_free_item(F f)
+	{
+		std::lock_guard<LockPolicy> l(_lock);
+		for (const item& i : _freeItems)
+		{
+			f(static_cast<const T*>(i.get()));
+		}
+	}
+
+	// set_connection()
+	// push the connection back to the pool
+	// if a reset function was given, the item is cleaned before any other caller can get it,
+	// when the reset throws the item is replaced as with discard()
+	void set_item(item& r)
+	{
+		const bool b_hold = tracking_checkouts();
+		interactive_pool_clock::time_point now;
+		if (b_hold)
+		{
+			now = interactive_pool_clock::now();
+		}
+		interactive_pool_duration held(0);
+		bool b_held = false;
+		base_detector* detector = nullptr;
+		trace_event(interactive_trace_release, r.get());
+
+		if (_backgroundReset)
+		{
+			{
+				std::lock_guard<LockPolicy> l(_lock);
+				remember_item(r);
+				if (b_hold)
+				{
+					b_held = checkin(r.get(), now, held);
+					detector = _holdDetector;
+				}
+				_dirtyItems.push_back(std::move(r));
+			}
+			_maintenanceCv.notify_one();
+		}
+		else
+		{
+			if (_reset && r)
+			{
+				try
+				{
+					_reset(*r);
+				}
+				catch (...)
+				{
+					// the item could not be cleaned, it is replaced as if it had been discarded
+					discard(r);
+					return;
+				}
+			}
+			std::lock_guard<LockPolicy> l(_lock);
+			remember_item(r);
+			if (b_hold)
+			{
+				b_held = checkin(r.get(), now, held);
+				detector = _holdDetector;
+			}
+			push_free_item(std::move(r));
+		}
+		_counters.in_use.fetch_sub(1, std::memory_order_relaxed);
+
+		if (b_held)
+		{
+			hold_finished(held, detector);
+		}
+	}
+	
+
+private:
+	// trace_event()
+	// records an event if the trace is enabled
+	void trace_event(interactive_trace_type type, const void* item)
+	{
+		interactive_event_trace* t = _eventTrace.load(std::memory_order_acquire);
+		if (t)
+		{
+			t->record(type, item);
+		}
+	}
+
+	// lease_slot
+	// checkout information of an item. Each item of the pool has its own slot
+	struct lease_slot
+	{
+		interactive_pool_clock::time_point checkout;
+		std::thread::id owner;
+		const char* tag = nullptr;
+		bool out = false;
+	};
+
+	// tracking_checkouts()
+	// true when the checkouts must be recorded in the slots (hold tracking or lease registry)
+	bool tracking_checkouts() const
+	{
+		return _holdTracking.load(std::memory_order_relaxed) || _leaseRegistry.load(std::memory_order_relaxed);
+	}
+
+	// register_item() / unregister_item()
+	// assign / free the slot of an item, must be called with the lock taken (or from the constructor)
+	void register_item(const T* p)
+	{
+		size_t n;
+		if (!_freeSlots.empty())
+		{
+			n = _freeSlots.back();
+			_freeSlots.pop_back();
+			_slots[n] = lease_slot();
+		}
+		else
+		{
+			n = _slots.size();
+			_slots.push_back(lease_slot());
+		}
+		_slotOf[p] = n;
+	}
+
+	void unregister_item(const T* p)
+	{
+		auto it = _slotOf.find(p);
+		if (it != _slotOf.end())
+		{
+			_freeSlots.push_back(it->second);
+			_slotOf.erase(it);
+		}
+	}
+
+	// checkout() / checkin()
+	// start and finish the hold time of an item, must be called with the lock taken
+	void checkout(const T* p)
+	{
+		auto it = _slotOf.find(p);
+		if (it != _slotOf.end())
+		{
+			lease_slot& s = _slots[it->second];
+			s.checkout = interactive_pool_clock::now();
+			s.owner = std::this_thread::get_id();
+			s.tag = nullptr;
+			s.out = true;
+		}
+	}
+
+	bool checkin(const T* p, const interactive_pool_clock::time_point& now, interactive_pool_duration& held)
+	{
+		auto it = _slotOf.find(p);
+		if (it == _slotOf.end() || !_slots[it->second].out)
+		{
+			return false;
+		}
+		lease_slot& s = _slots[it->second];
+		s.out = false;
+		s.tag = nullptr;
+		held = std::chrono::duration_cast<interactive_pool_duration>(now - s.checkout);
+		return true;
+	}
+
+	// hold_finished()
+	// reports a hold time, called out of the lock
+	void hold_finished(const interactive_pool_duration& held, base_detector* detector)
+	{
+		interactive_latency_histogram* h = _holdHistogram.load(std::memory_order_acquire);
+		if (h)
+		{
+			h->record(held);
+		}
+		_counters.hold_ns.fetch_add(static_cast<uint64_t>(held.count()), std::memory_order_relaxed);
+		if (detector)
+		{
+			detector->set_elapsed_time(held);
+		}
+	}
+
+	// pop_free_item()
+	// removes the next item from the free list, must be called with the lock taken and items available
+	item pop_free_item()
+	{
+		if (_affinity)
+		{
+			const T* last = _lastItem[interactive_thread_index() % affinity_slots];
+			if (last)
+			{
+				// recently released items are at the back. Only the last affinity_scan ones are looked at,
+				// an item released before them is unlikely to be still in the cache and the lookup stays O(1)
+				size_t n = (_freeItems.size() < affinity_scan) ? _freeItems.size() : affinity_scan;
+				for (auto it = _freeItems.rbegin(); it != _freeItems.rbegin() + n; ++it)
+				{
+					if (it->get() == last)
+					{
+						item j = std::move(*it);
+						_freeItems.erase(std::next(it).base());
+						_counters.free.fetch_sub(1, std::memory_order_relaxed);
+						_affinityHits.fetch_add(1, std::memory_order_relaxed);
+						return j;
+					}
+				}
+			}
+			_affinityMisses.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		_counters.free.fetch_sub(1, std::memory_order_relaxed);
+		return OrderPolicy::take(_freeItems);
+	}
+
+	// push_free_item()
+	// puts an item in the free list, must be called with the lock taken
+	void push_free_item(item&& j)
+	{
+		_freeItems.push_back(std::move(j));
+		_counters.free.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// item_out()
+	// counts an item given to a caller
+	void item_out()
+	{
+		_counters.acquires.fetch_add(1, std::memory_order_relaxed);
+		uint64_t n = _counters.in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+		uint64_t peak = _counters.peak_in_use.load(std::memory_order_relaxed);
+		while (n > peak && !_counters.peak_in_use.compare_exchange_weak(peak, n, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	// remember_item()
+	// keeps the last item released by the calling thread, must be called with the lock taken
+	void remember_item(const item& r)
+	{
+		if (_affinity)
+		{
+			_lastItem[interactive_thread_index() % affinity_slots] = r.get();
+		}
+	}
+
+private:
+	// maintenance()
+	// internal thread, resets the released items and replaces the discarded ones
+	// out of the callers' critical path
+	void maintenance()
+	{
+		std::unique_lock<LockPolicy> l(_lock);
+		while (!_stop)
+		{
+			if (!_discardedItems.empty())
+			{
+				item j = std::move(_discardedItems.front());
+				_discardedItems.pop_front();
+				l.unlock();
+
+				// the broken item is destroyed here, not in the caller
+				j.reset();
+				_counters.destroyed.fetch_add(1, std::memory_order_relaxed);
+				try
+				{
+					j = std::make_unique<T>();
+					_counters.created.fetch_add(1, std::memory_order_relaxed);
+				}
+				catch (...)
+				{
+					// the replacement could not be built, the pool keeps one item less
+				}
+
+				l.lock();
+				_replacing--;
+				if (j)
+				{
+					register_item(j.get());
+					push_free_item(std::move(j));
+				}
+				else
+				{
+					_initialSize--;
+				}
+				continue;
+			}
+
+			if (_dirtyItems.empty())
+			{
+				_maintenanceCv.wait(l);
+				continue;
+			}
+
+			item j = std::move(_dirtyItems.front());
+			_dirtyItems.pop_front();
+			_resetting++;
+			l.unlock();
+
+			bool b_reset_ok = true;
+			if (j)
+			{
+				try
+				{
+					_reset(*j);
+				}
+				catch (...)
+				{
+					// the item could not be cleaned, it is replaced as if it had been discarded
+					b_reset_ok = false;
+				}
+			}
+
+			l.lock();
+			_resetting--;
+			if (b_reset_ok)
+			{
+				push_free_item(std::move(j));
+			}
+			else
+			{
+				unregister_item(j.get());
+				trace_event(interactive_trace_discard, j.get());
+				_discardedItems.push_back(std::move(j));
+				_replacing++;
+			}
+		}
+	}
+
+private:
+	size_t				 _initialSize;
+	std::deque < item > _freeItems;
+	LockPolicy		     _lock;
+	ValidatorPolicy		 _validator;
+	MetricsPolicy		 _metrics;
+
+	reset_function		 _reset;
+	bool				 _backgroundReset;
+	std::deque < item > _dirtyItems;		// released items waiting for the background reset
+	size_t				 _resetting;		// items being reset right now
+	std::deque < item > _discardedItems;	// broken items waiting to be destroyed and replaced
+	size_t				 _replacing;		// discarded items whose replacement is not in the pool yet
+	bool				 _stop;
+	std::condition_variable_any _maintenanceCv;
+	std::thread			 _maintenance;
+
+	bool				 _affinity;
+	static const size_t affinity_slots = 64;
+	static const size_t affinity_scan = 8;	// free items looked at from the back to find the last one of a thread
+	std::vector< const T* > _lastItem;	// last item released by each thread, by interactive_thread_index()
+	std::atomic<uint64_t> _affinityHits;
+	std::atomic<uint64_t> _affinityMisses;
+
+	std::unique_ptr< interactive_latency_histogram > _acquireHistogramOwner;
+	std::atomic< interactive_latency_histogram* > _acquireHistogram;
+
+	std::unordered_map< const T*, size_t > _slotOf;	// slot of each item
+	std::vector< lease_slot > _slots;
+	std::vector< size_t > _freeSlots;					// slots of discarded items, reused by their replacements
+	std::atomic<bool>	 _holdTracking;
+	std::atomic<bool>	 _leaseRegistry;
+
+	// counters of stats(), updated with relaxed atomics
+	struct pool_counters
+	{
+		std::atomic<uint64_t> created{0};
+		std::atomic<uint64_t> destroyed{0};
+		std::atomic<uint64_t> free{0};
+		std::atomic<uint64_t> in_use{0};
+		std::atomic<uint64_t> peak_in_use{0};
+		std::atomic<uint64_t> waiters{0};
+		std::atomic<uint64_t> acquires{0};
+		std::atomic<uint64_t> timeouts{0};
+		std::atomic<uint64_t> validation_failures{0};
+		std::atomic<uint64_t> wait_ns{0};
+		std::atomic<uint64_t> hold_ns{0};
+	} _counters;
+	std::unique_ptr< interactive_latency_histogram > _holdHistogramOwner;
+	std::atomic< interactive_latency_histogram* > _holdHistogram;
+	base_detector*		 _holdDetector;
+	std::atomic< base_detector* > _acquireDetector;
+
+	// event trace, see enable_event_trace()
+	std::unique_ptr< interactive_event_trace > _eventTraceOwner;
+	std::atomic< interactive_event_trace* > _eventTrace;
+};
+
+
+
+/// interactive_numa_pool
+/// NUMA aware pool, keeps one interactive_pool per memory node.
+/// summary: the items of each node are created (and first touched) by a thread bound to the cpus of that node,
+/// so their memory lives in the node. get_item() serves the caller from its local node and only falls back
+/// to remote nodes when the local one is empty. Items always go back to the node where they were created.
+/// The topology is read from /sys/devices/system/node, on other platforms there is a single node.
+template <class T> class interactive_numa_pool
+{
+public:
+	// defines a pool's item, same as interactive_pool
+	typedef typename interactive_pool<T>::item item;
+
+	// Constructor
+	// size : total number of resources, spread evenly between the nodes
+	// reset, background_reset : same as interactive_pool, applied on every node
+	interactive_numa_pool(size_t size, typename interactive_pool<T>::reset_function reset = {}, bool background_reset = false)
+	{
+		std::vector<int> ids = read_node_list();
+
+		for (size_t n = 0; n < ids.size(); n++)
+		{
+			node nd;
+			nd.id = ids[n];
+			nd.cpus = read_cpu_list(std::string("/sys/devices/system/node/node") + std::to_string(ids[n]) + "/cpulist");
+			_nodes.push_back(std::move(nd));
+		}
+
+		// cpu -> node lookup table, used to find the caller's node
+		for (size_t n = 0; n < _nodes.size(); n++)
+		{
+			for (int cpu : _nodes[n].cpus)
+			{
+				if (cpu >= static_cast<int>(_cpuToNode.size()))
+				{
+					_cpuToNode.resize(cpu + 1, 0);
+				}
+				_cpuToNode[cpu] = n;
+			}
+		}
+
+		// build each sub pool from a thread bound to the node cpus
+		for (size_t n = 0; n < _nodes.size(); n++)
+		{
+			size_t count = size / _nodes.size() + ((n < size % _nodes.size()) ? 1 : 0);
+			node& nd = _nodes[n];
+			std::thread builder([&nd, count, &reset, background_reset]()
+				{
+					bind_current_thread(nd.cpus);
+					nd.pool.reset(new interactive_pool<T>(count, reset, background_reset));
+				});
+			builder.join();
+
+			// remember the initial owner node of every item, this map is read only from now on.
+			// Items replaced later by a sub-pool are not in it, see set_item()
+			nd.pool->for_each_free_item([this, n](const T* i) { _owner[i] = n; });
+		}
+	}
+
+	//check_before_destruct()
+	// same as interactive_pool::check_before_destruct(), checks every node
+	void check_before_destruct()
+	{
+		std::for_each(_nodes.begin(), _nodes.end(), [](node& nd) {nd.pool->check_before_destruct(); });
+	}
+
+	// get_item()
+	// returns a item to caller or throw an exception if pool is empty
+	// Searches first in the caller's node and then in the remote ones
+	// Parameters are the same as interactive_pool::get_item()
+	item get_item(uint32_t max_wait_ms = std::numeric_limits<uint32_t>::max(), interactive_pool_time* time_elapsed_ms = nullptr, std::function<bool(item&)> f = {})
+	{
+		auto t0 = interactive_pool_clock::now();
+		std::chrono::duration<double, std::milli> elapsed;
+
+		if (time_elapsed_ms)
+		{
+			// get initial time point if metric is requested
+			time_elapsed_ms->init = interactive_pool_clock::now();
+		}
+
+		size_t local = current_node();
+
+		do
+		{
+			item j;
+			for (size_t k = 0; k < _nodes.size(); k++)
+			{
+				// local node first, then the rest in order
+				if (_nodes[(local + k) % _nodes.size()].pool->try_get_item(j, f))
+				{
+					if (time_elapsed_ms)
+					{
+						// if metric is requested, calculate elapsed time
+						time_elapsed_ms->finish = interactive_pool_clock::now();
+						time_elapsed_ms->elapsed_time = std::chrono::duration_cast<interactive_pool_duration>(time_elapsed_ms->finish - time_elapsed_ms->init);
+					}
+					return j;
+				}
+			}
+
+			// not items available, wait till timeout
+			elapsed = (interactive_pool_clock::now() - t0);
+			// rest a little
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		} while (elapsed.count() < max_wait_ms);
+
+		// no free items
+		throw std::runtime_error("interactive_numa_pool: All items are in use");
+	}
+
+	// get_available_count()
+	// returns the number of free items in all nodes
+	size_t get_available_count()
+	{
+		size_t count = 0;
+		std::for_each(_nodes.begin(), _nodes.end(), [&count](node& nd) {count += nd.pool->get_available_count(); });
+		return count;
+	}
+
+	// set_item()
+	// push the item back to the node where it was created
+	// The initial owner is only a hint: a sub-pool replaces discarded items with new ones that may
+	// reuse a freed address, so the owner is confirmed and the nodes are asked when it is not
+	void set_item(item& r)
+	{
+		auto it = _owner.find(r.get());
+		if (it != _owner.end() && _nodes[it->second].pool->owns(r.get()))
+		{
+			_nodes[it->second].pool->set_item(r);
+			return;
+		}
+
+		for (node& nd : _nodes)
+		{
+			if (nd.pool->owns(r.get()))
+			{
+				nd.pool->set_item(r);
+				return;
+			}
+		}
+		throw std::runtime_error("interactive_numa_pool: item does not belong to this pool");
+	}
+
+	// get_node_count()
+	// returns the number of memory nodes managed by the pool
+	size_t get_node_count() const
+	{
+		return _nodes.size();
+	}
+
+	// current_node()
+	// returns the index of the node that owns the cpu running the caller
+	size_t current_node() const
+	{
+#if defined(__linux__)
+		int cpu = sched_getcpu();
+		if (cpu >= 0 && cpu < static_cast<int>(_cpuToNode.size()))
+		{
+			return _cpuToNode[cpu];
+		}
+#endif
+		return 0;
+	}
+
+private:
+	struct node
+	{
+		int id = 0;
+		std::vector<int> cpus;
+		std::unique_ptr<interactive_pool<T>> pool;
+	};
+
+	// parses a kernel list as "0-3,8-11" 
+	static std::vector<int> parse_list(const std::string& s)
+	{
+		std::vector<int> r;
+		std::stringstream ss(s);
+		std::string range;
+		while (std::getline(ss, range, ','))
+		{
+			if (range.empty() || !isdigit(static_cast<unsigned char>(range[0])))
+			{
+				continue;
+			}
+			size_t dash = range.find('-');
+			int first = std::stoi(range.substr(0, dash));
+			int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+			for (int i = first; i <= last; i++)
+			{
+				r.push_back(i);
+			}
+		}
+		return r;
+	}
+
+	static std::vector<int> read_cpu_list(const std::string& path)
+	{
+		std::ifstream f(path);
+		std::string s;
+		std::getline(f, s);
+		return parse_list(s);
+	}
+
+	// online nodes, a single node 0 when the topology is not available
+	static std::vector<int> read_node_list()
+	{
+		std::vector<int> r;
+#if defined(__linux__)
+		r = read_cpu_list("/sys/devices/system/node/online");
+#endif
+		if (r.empty())
+		{
+			r.push_back(0);
+		}
+		return r;
+	}
+
+	// binds the calling thread to the given cpus, does nothing if they are unknown
+	static void bind_current_thread(const std::vector<int>& cpus)
+	{
+#if defined(__linux__)
+		if (cpus.empty())
+		{
+			return;
+		}
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		std::for_each(cpus.begin(), cpus.end(), [&set](int cpu) { if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set); });
+		sched_setaffinity(0, sizeof(set), &set);
+#else
+		(void)cpus;
+#endif
+	}
+
+private:
+	std::vector< node >					_nodes;
+	std::vector< size_t >				_cpuToNode;
+	std::unordered_map< const T*, size_t > _owner;
+};
+
+
+
+/// interactive_keyed_pool
+/// One logical pool that manages a sub-pool of items for each key (ex. a backend shard)
+/// summary: items are created on demand for each key, up to a per key maximum and a global maximum.
+/// When the global maximum is reached, idle items of the coldest keys (least recently used) are
+/// destroyed to make room for the requested key. Keys never lose their minimum of items by eviction.
+template <class Key, class T> class interactive_keyed_pool
+{
+public:
+	// defines a pool's item
+	typedef std::unique_ptr< T > item;
+	// defines the function used to create a new item for a key
+	typedef std::function<item(const Key&)> create_function;
+
+	// Constructor
+	// min_per_key	: items of a key that will never be evicted to serve other keys
+	// max_per_key	: maximum number of items of a single key
+	// max_total	: maximum number of items between all keys
+	// create		: function that builds a new item for a key. Default creates T with its default constructor,
+	//				  it is required (or the constructor throws) when T has none
+	interactive_keyed_pool(size_t min_per_key, size_t max_per_key, size_t max_total, create_function create = {})
+		: _minPerKey(min_per_key)
+		, _maxPerKey(max_per_key)
+		, _maxTotal(max_total)
+		, _create(create)
+		, _total(0)
+		, _tick(0)
+		, _evictions(0)
+	{
+		if (!_create)
+		{
+			_create = default_create(std::is_default_constructible<T>());
+			if (!_create)
+			{
+				throw std::runtime_error("interactive_keyed_pool: a create function is needed for this type");
+			}
+		}
+	}
+
+	//check_before_destruct()
+	// same as interactive_pool::check_before_destruct(), throws if some item of any key was not released
+	void check_before_destruct()
+	{
+		std::lock_guard<std::mutex> l(_lock);
+		size_t current = 0;
+		std::for_each(_pools.begin(), _pools.end(), [&current](const std::pair<const Key, sub_pool>& p) {current += p.second.free.size(); });
+		if (current != _total)
+		{
+			throw std::runtime_error(std::string(std::string("interactive_keyed_pool: Different count of items. Pool has created [") + std::to_string(_total) + std::string("] but during destruction have [") + std::to_string(current) + std::string("]")));
+		}
+	}
+
+	// Destructor
+	// releases all items
+	virtual ~interactive_keyed_pool()
+	{
+		_pools.clear();
+	}
+
+	// get_item()
+	// returns a item of the given key or throw an exception if none is available
+	// key				: sub-pool to use
+	// other parameters are the same as interactive_pool::get_item()
+	item get_item(const Key& key, uint32_t max_wait_ms = std::numeric_limits<uint32_t>::max(), interactive_pool_time* time_elapsed_ms = nullptr, std::function<bool(item&)> f = {})
+	{
+		auto t0 = interactive_pool_clock::now();
+		std::chrono::duration<double, std::milli> elapsed;
+
+		if (time_elapsed_ms)
+		{
+			// get initial time point if metric is requested
+			time_elapsed_ms->init = interactive_pool_clock::now();
+		}
+
+		do
+		{
+			item j;
+			if (try_get_item(key, j, f))
+			{
+				if (time_elapsed_ms)
+				{
+					// if metric is requested, calculate elapsed time
+					time_elapsed_ms->finish = interactive_pool_clock::now();
+					time_elapsed_ms->elapsed_time = std::chrono::duration_cast<interactive_pool_duration>(time_elapsed_ms->finish - time_elapsed_ms->init);
+				}
+				return j;
+			}
+
+			// not items available, wait till timeout
+			elapsed = (interactive_pool_clock::now() - t0);
+			// rest a little
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		} while (elapsed.count() < max_wait_ms);
+
+		// no free items
+		throw std::runtime_error("interactive_keyed_pool: All items are in use");
+	}
+
+	// try_get_item()
+	// single attempt to get an item of the key: a free one, a new one if the limits allow it,
+	// or a new one in place of an idle item of a cold key. Never waits and never throws by itself
+	bool try_get_item(const Key& key, item& r, const std::function<bool(item&)>& f = {})
+	{
+		item evicted;
+		{ // lock scope
+			std::unique_lock<std::mutex> l(_lock);
+			sub_pool& sp = _pools[key];
+			sp.last_use = ++_tick;
+
+			if (!sp.free.empty())
+			{
+				item j = std::move(sp.free.front());
+				sp.free.pop_front();
+				// if a check or initialize function is defined, call it
+				if (!f || f(j))
+				{
+					r = std::move(j);
+					return true;
+				}
+				sp.free.push_back(std::move(j));
+				return false;
+			}
+
+			if (sp.total >= _maxPerKey)
+			{
+				return false;
+			}
+
+			if (_total >= _maxTotal)
+			{
+				// global limit reached, take the place of an idle item of the coldest key
+				sub_pool* cold = nullptr;
+				for (auto& p : _pools)
+				{
+					sub_pool& c = p.second;
+					if (&c != &sp && !c.free.empty() && c.total > _minPerKey && (!cold || c.last_use < cold->last_use))
+					{
+						cold = &c;
+					}
+				}
+				if (!cold)
+				{
+					return false;
+				}
+				evicted = std::move(cold->free.back());
+				cold->free.pop_back();
+				cold->total--;
+				_total--;
+				_evictions++;
+			}
+
+			// reserve the place of the new item, it is created out of the lock
+			sp.total++;
+			_total++;
+		} // end lock scope
+
+		evicted.reset();
+
+		item j;
+		try
+		{
+			j = _create(key);
+		}
+		catch (...)
+		{
+			unreserve(key);
+			throw;
+		}
+
+		if (f && !f(j))
+		{
+			// keep the new item for the next attempt
+			std::lock_guard<std::mutex> l(_lock);
+			_pools[key].free.push_back(std::move(j));
+			return false;
+		}
+		r = std::move(j);
+		return true;
+	}
+
+	// set_item()
+	// push the item back to the sub-pool of its key
+	void set_item(const Key& key, item& r)
+	{
+		std::lock_guard<std::mutex> l(_lock);
+		_pools[key].free.push_back(std::move(r));
+	}
+
+	// get_available_count()
+	// returns the number of free items of a key
+	size_t get_available_count(const Key& key)
+	{
+		std::lock_guard<std::mutex> l(_lock);
+		auto it = _pools.find(key);
+		return (it == _pools.end()) ? 0 : it->second.free.size();
+	}
+
+	// get_total_count()
+	// returns the number of items created between all keys (free and in use)
+	size_t get_total_count()
+	{
+		std::lock_guard<std::mutex> l(_lock);
+		return _total;
+	}
+
+	// get_eviction_count()
+	// returns how many idle items were destroyed to serve other keys
+	uint64_t get_eviction_count()
+	{
+		std::lock_guard<std::mutex> l(_lock);
+		return _evictions;
+	}
+
+private:
+	struct sub_pool
+	{
+		std::deque< item > free;
+		size_t total = 0;		// free and in use items of the key
+		uint64_t last_use = 0;	// tick of the last request, used to find cold keys
+	};
+
+	// default_create()
+	// builds T with its default constructor, types without it need the create function
+	static create_function default_create(std::true_type)
+	{
+		return [](const Key&) { return std::make_unique<T>(); };
+	}
+	static create_function default_create(std::false_type)
+	{
+		return create_function();
+	}
+
+	void unreserve(const Key& key)
+	{
+		std::lock_guard<std::mutex> l(_lock);
+		_pools[key].total--;
+		_total--;
+	}
+
+private:
+	size_t					_minPerKey;
+	size_t					_maxPerKey;
+	size_t					_maxTotal;
+	create_function			_create;
+	std::map< Key, sub_pool > _pools;
+	size_t					_total;
+	uint64_t				_tick;
+	uint64_t				_evictions;
+	std::mutex				_lock;
+};
+
+
+
+
+
+
+/// interactive_bounded_queue
+/// bounded lock free queue of fixed capacity (D. Vyukov's bounded MPMC algorithm), used as multi producer
+/// single consumer by interactive_alert_dispatcher. Each cell has a sequence number that tells producers
+/// and consumers whether it is free or full, a push or pop is one compare and swap on the position.
+/// The capacity is rounded up to a power of two. push() never waits, it returns false when the queue is full
+template < class E > class interactive_bounded_queue
+{public:
+
+	explicit interactive_bounded_queue(size_t capacity)
+		: _mask(1)
+		, _push_at(0)
+		, _pop_at(0)
+	{
+		size_t size = 2;
+		while (size < capacity)
+		{
+			size <<= 1;
+		}
+		_mask = size - 1;
+		_cells.reset(new cell[size]);
+		for (size_t i = 0; i < size; i++)
+		{
+			_cells[i].seq.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	bool push(const E& e)
+	{
+		size_t pos = _push_at.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			cell& c = _cells[pos & _mask];
+			size_t seq = c.seq.load(std::memory_order_acquire);
+			intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if (dif == 0)
+			{
+				if (_push_at.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					c.data = e;
+					c.seq.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (dif < 0)
+			{
+				// full
+				return false;
+			}
+			else
+			{
+				pos = _push_at.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// empty()
+	// true when no push has been started after the last pop. A push in progress counts as not empty
+	bool empty() const
+	{
+		return _push_at.load(std::memory_order_seq_cst) == _pop_at.load(std::memory_order_seq_cst);
+	}
+
+	bool pop(E& e)
+	{
+		size_t pos = _pop_at.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			cell& c = _cells[pos & _mask];
+			size_t seq = c.seq.load(std::memory_order_acquire);
+			intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+			if (dif == 0)
+			{
+				if (_pop_at.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					e = std::move(c.data);
+					c.seq.store(pos + _mask + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (dif < 0)
+			{
+				// empty
+				return false;
+			}
+			else
+			{
+				pos = _pop_at.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+private:
+	struct cell
+	{
+		std::atomic<size_t> seq;
+		E data;
+	};
+
+	size_t _mask;
+	std::unique_ptr< cell[] > _cells;
+	// producers and consumer on different cache lines
+	alignas(64) std::atomic<size_t> _push_at;
+	alignas(64) std::atomic<size_t> _pop_at;
+};
+
+
+
+/// interactive_alert_dispatcher
+/// Moves the detector callbacks out of the acquisition path: the functions given by wrap() only queue the
+/// alert in a bounded lock free queue, and a thread of the dispatcher calls the user functions.
+/// When the queue is full the alert is dropped and counted (see get_overflow_count()), the caller never waits.
+/// The dispatcher thread sleeps on a condition variable while the queue is empty, the callers only take
+/// its mutex to wake it up, when it is sleeping.
+/// The dispatcher must outlive the detectors that use it
+template < class T > class interactive_alert_dispatcher
+{public:
+
+	typedef std::function<void(T,  interactive_pool_duration, interactive_pool_duration)> call_back ;
+	typedef std::function<void(T,  interactive_pool_duration, interactive_pool_duration, uint64_t)> coalesced_call_back ;
+
+	// capacity		: maximum alerts waiting to be delivered
+	explicit interactive_alert_dispatcher( size_t capacity = 1024 )
+		: _queue(capacity)
+		, _sleeping(false)
+		, _stop(false)
+		, _dispatched(0)
+		, _overflow(0)
+	{
+		_thread = std::thread(&interactive_alert_dispatcher::run, this);
+	}
+
+	// destructor, delivers the alerts already queued and stops the thread
+	virtual ~interactive_alert_dispatcher()
+	{
+		{
+			std::lock_guard<std::mutex> l(_wake_lock);
+			_stop.store(true, std::memory_order_release);
+		}
+		_wake.notify_one();
+		_thread.join();
+	}
+
+	// wrap()
+	// returns a function to give to a detector instead of fcn. It queues the alert, fcn is called later
+	// from the dispatcher thread
+	call_back wrap( call_back fcn )
+	{
+		const coalesced_call_back* target = keep( [fcn](T id, interactive_pool_duration level, interactive_pool_duration value, uint64_t) { fcn(id, level, value); } );
+		return [this, target](T id, interactive_pool_duration level, interactive_pool_duration value) { post(target, id, level, value, 1); };
+	}
+
+	// wrap_coalesced()
+	// same as wrap() for the coalesced function of set_debounce()
+	coalesced_call_back wrap_coalesced( coalesced_call_back fcn )
+	{
+		const coalesced_call_back* target = keep(fcn);
+		return [this, target](T id, interactive_pool_duration level, interactive_pool_duration value, uint64_t times) { post(target, id, level, value, times); };
+	}
+
+	// alerts delivered to the user functions
+	uint64_t get_dispatched_count() const
+	{
+		return _dispatched.load(std::memory_order_relaxed);
+	}
+
+	// alerts dropped because the queue was full
+	uint64_t get_overflow_count() const
+	{
+		return _overflow.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct alert
+	{
+		const coalesced_call_back* fcn;
+		T id;
+		interactive_pool_duration level;
+		interactive_pool_duration value;
+		uint64_t times;
+	};
+
+	// the functions are kept in a deque, their address does not change while others are added
+	const coalesced_call_back* keep( coalesced_call_back fcn )
+	{
+		std::lock_guard<std::mutex> l(_lock);
+		_functions.push_back(fcn);
+		return &_functions.back();
+	}
+
+	void post( const coalesced_call_back* fcn, const T& id, interactive_pool_duration level, interactive_pool_duration value, uint64_t times )
+	{
+		alert a = { fcn, id, level, value, times };
+		if (!_queue.push(a))
+		{
+			_overflow.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		// pairs with the fence of run(): either the dispatcher sees the alert or this sees it sleeping
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (_sleeping.load(std::memory_order_relaxed))
+		{
+			std::lock_guard<std::mutex> l(_wake_lock);
+			_wake.notify_one();
+		}
+	}
+
+	void run()
+	{
+		alert a;
+		for (;;)
+		{
+			// read the flag before the queue, so nothing queued before the stop is left behind
+			const bool b_stop = _stop.load(std::memory_order_acquire);
+			bool b_any = false;
+			while (_queue.pop(a))
+			{
+				b_any = true;
+				(*a.fcn)(a.id, a.level, a.value, a.times);
+				_dispatched.fetch_add(1, std::memory_order_relaxed);
+			}
+			if (b_stop)
+			{
+				break;
+			}
+			if (!b_any)
+			{
+				std::unique_lock<std::mutex> l(_wake_lock);
+				_sleeping.store(true, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (_queue.empty() && !_stop.load(std::memory_order_acquire))
+				{
+					_wake.wait(l);
+				}
+				_sleeping.store(false, std::memory_order_relaxed);
+			}
+		}
+	}
+
+private:
+	interactive_bounded_queue< alert > _queue;
+	std::mutex _wake_lock;
+	std::condition_variable _wake;
+	std::atomic<bool> _sleeping;
+	std::deque< coalesced_call_back > _functions;
+	std::mutex _lock;
+	std::atomic<bool> _stop;
+	std::atomic<uint64_t> _dispatched;
+	std::atomic<uint64_t> _overflow;
+	std::thread _thread;
+};
+
+
+
+/// interactive_detector_alarm
+/// Alarm logic shared by the detectors: identifier, trigger level and user function.
+/// By default the function is called on every sample that is over the trigger level. With set_debounce():
+///  - hysteresis, once the alarm is on it stays on until the value goes down to the exit level
+///  - rate limit, the function is called at most once per interval while the alarm is on
+///  - the calls skipped in between are counted, and given to the coalesced function if there is one
+/// The state is kept in atomics, so it is safe with the detectors shared by several threads
+template < class T > class interactive_detector_alarm
+{public:
+
+	// callback prototipe, parameters: id, trigger level, value
+	typedef std::function<void(T,  interactive_pool_duration, interactive_pool_duration)> call_back ;
+	// coalesced callback prototipe, also receives the number of times the alarm fired since the last call
+	typedef std::function<void(T,  interactive_pool_duration, interactive_pool_duration, uint64_t)> coalesced_call_back ;
+
+	// set_debounce()
+	// exit_level	: the alarm ends when the value is not above it (lower or equal than the trigger level)
+	// min_interval	: minimum time between two calls
+	// fcn			: optional, called instead of the detector function with the coalesced count,
+	//				  and once more when the alarm ends if some fires were not reported
+	// Call it before the detector is used
+	void set_debounce( interactive_pool_duration exit_level, interactive_pool_duration min_interval, coalesced_call_back fcn = coalesced_call_back() )
+	{
+		_debounce = true;
+		_exit_level = std::min(exit_level, _trigger_level);
+		_min_interval = min_interval.count();
+		_coalesced_call_back = std::move(fcn);
+	}
+
+	// number of times the alarm fired, reported or not
+	uint64_t get_fired_count() const
+	{
+		return _fired.load(std::memory_order_relaxed);
+	}
+
+protected:
+	interactive_detector_alarm( T id, interactive_pool_duration trigger_level, call_back fcn )
+		: _id(id)
+		, _trigger_level(trigger_level)
+		, _lcall_back(std::move(fcn))
+		, _debounce(false)
+		, _exit_level(trigger_level)
+		, _min_interval(0)
+		, _fired(0)
+		{}
+
+	// alarm_state
+	// state of one alarm. The detectors with a second kind of alarm keep another one
+	struct alarm_state
+	{
+		std::atomic<bool> active;
+		std::atomic<uint64_t> pending;
+		std::atomic<int64_t> last_call;
+
+		alarm_state() : active(false), pending(0), last_call(std::numeric_limits<int64_t>::min() / 2) {}
+	};
+
+	// level where the alarm ends (the trigger level without debounce)
+	interactive_pool_duration exit_level() const
+	{
+		return _exit_level;
+	}
+
+	// alarm()
+	// called by the detector on each sample
+	// b_enter	: the value is over the trigger level
+	// b_stay	: the value is over the exit level
+	// value	: returns the value to report, only called when the user function is called
+	template <class F>
+	void alarm( bool b_enter, bool b_stay, const F& value )
+	{
+		alarm( _state, _trigger_level, b_enter, b_stay, value );
+	}
+
+	// alarm()
+	// same, with its own state and the level to report
+	template <class F>
+	void alarm( alarm_state& state, interactive_pool_duration level, bool b_enter, bool b_stay, const F& value )
+	{
+		if (!_debounce)
+		{
+			if (b_enter)
+			{
+				_fired.fetch_add(1, std::memory_order_relaxed);
+				_lcall_back( _id, level, value() );
+			}
+			return;
+		}
+
+		if (b_enter)
+		{
+			if (!state.active.load(std::memory_order_relaxed))
+			{
+				state.active.store(true, std::memory_order_relaxed);
+			}
+		}
+		else if (!b_stay || !state.active.load(std::memory_order_relaxed))
+		{
+			if (state.active.load(std::memory_order_relaxed))
+			{
+				state.active.store(false, std::memory_order_relaxed);
+				// the fires not reported yet belong to this incident, they are flushed to the
+				// coalesced function (with the current value) or dropped, never carried to the next one
+				const uint64_t times = state.pending.exchange(0, std::memory_order_relaxed);
+				if (times && _coalesced_call_back)
+				{
+					_coalesced_call_back( _id, level, value(), times );
+				}
+			}
+			return;
+		}
+
+		_fired.fetch_add(1, std::memory_order_relaxed);
+		state.pending.fetch_add(1, std::memory_order_relaxed);
+		const int64_t now = std::chrono::duration_cast<interactive_pool_duration>(interactive_pool_clock::now().time_since_epoch()).count();
+		int64_t last = state.last_call.load(std::memory_order_relaxed);
+		if (now - last < _min_interval || !state.last_call.compare_exchange_strong(last, now, std::memory_order_relaxed))
+		{
+			// too soon, or another thread is reporting
+			return;
+		}
+		const uint64_t times = state.pending.exchange(0, std::memory_order_relaxed);
+		if (_coalesced_call_back)
+		{
+			_coalesced_call_back( _id, level, value(), times );
+		}
+		else
+		{
+			_lcall_back( _id, level, value() );
+		}
+	}
+
+protected:
+	T _id;
+	interactive_pool_duration _trigger_level;
+	call_back _lcall_back;
+
+private:
+	bool _debounce;
+	interactive_pool_duration _exit_level;
+	int64_t _min_interval;
+	coalesced_call_back _coalesced_call_back;
+	alarm_state _state;
+	std::atomic<uint64_t> _fired;
+};
+
+
+
+/// interactive_average_detector
+/// Metric facilities function, call a specific function when the average of 
+/// last "n" calls to get_item exceed the limit
+/// The samples are kept in a fixed ring with a running sum: each sample costs the same
+/// whatever the window size and nothing is allocated after the constructor
+template < class T > class interactive_average_detector final : public base_detector, public interactive_detector_alarm<T>
+{public:
+
+	// calback definition
+	typedef typename interactive_detector_alarm<T>::call_back _average_limit_call_back ;
+	interactive_average_detector( T id, size_t samples , interactive_pool_duration trigger_level, _average_limit_call_back fcn )
+		: interactive_detector_alarm<T>(id, trigger_level, std::move(fcn))
+		, _samples_count(samples ? samples : 1), _samples(_samples_count), _next(0), _filled(0), _sum(0)
+		{}
+
+	// timming control function
+	virtual void set_elapsed_time( const interactive_pool_duration& i )
+	{
+		// replace the oldest value (nothing to remove while the buffer is not full)
+		_sum += i - _samples[_next];
+		_samples[_next] = i;
+		if( ++_next == _samples_count )
+		{
+			_next = 0;
+		}
+
+		if( _filled < _samples_count )
+		{
+			_filled++;
+		}
+
+		if( _filled == _samples_count )
+		{
+			// calculate the averange if the buffer is completed
+			interactive_pool_duration cur = average();
+			// call designed function if it is over the limit
+			this->alarm( cur > this->_trigger_level, cur > this->exit_level(), [cur]() { return cur; } );
+		}
+	}
+	
+	// auxiliar method, calculates the time average of all samples
+	interactive_pool_duration average() const 
+	{
+		return _filled == 0 ? interactive_pool_duration(0) : (_sum / static_cast<interactive_pool_duration::rep>(_filled));
+	}
+	
+private:
+	size_t _samples_count;
+	std::vector<interactive_pool_duration> _samples;	// ring, _next is the oldest value once it is full
+	size_t _next;
+	size_t _filled;
+	interactive_pool_duration _sum;						// 64 bits nanoseconds
+};
+
+
+
+/// interactive_peak_detector
+/// Calls a user function each time that the elapsed time to get a item in the pool
+/// exceeds the set trigger value
+template < class T > class interactive_peak_detector final : public base_detector, public interactive_detector_alarm<T>
+{public:
+
+	// callback prototipe
+	typedef typename interactive_detector_alarm<T>::call_back _peack_detected_call_back ;
+	// constructor
+	// id			: identifier, at the discretion of the user, to identify the thread or instances that have issued the peak signal. 
+	// trigger_level: Maximum time (ex. std::chrono::milliseconds(100)). If this time is exceeded while waiting for the free item in the pool. 
+	// 				  The function designated as callback is called. It does not affect the wait for items pool.
+	// fcn			: user-defined function, called when peak detection occurs
+	//				  parameters :
+	//					id: Defined by user
+	//					level: conffigured trigger level
+	//					elapsed_time: detected peak value
+	interactive_peak_detector( T id,  interactive_pool_duration trigger_level, _peack_detected_call_back fcn )
+		: interactive_detector_alarm<T>(id, trigger_level, std::move(fcn))
+		{}
+
+	// check the elapsed time comparing it with the configured trigger_level
+	// calls user callback function f necessary
+	virtual void set_elapsed_time( const interactive_pool_duration& i )
+	{
+		this->alarm( i > this->_trigger_level, i > this->exit_level(), [&i]() { return i; } );
+	}
+};
+
+
+
+/// interactive_shared_average_detector
+/// Thread safe version of interactive_average_detector, one instance can be fed by all the threads
+/// (ex. attached to the pool with set_acquire_detector()) to watch the average of the whole pool.
+/// The last samples are kept in a ring of atomics with a running sum, each sample is a few atomic
+/// operations, without mutex nor allocation. With concurrent callers the window is the last samples
+/// in the order they took their position in the ring
+template < class T > class interactive_shared_average_detector final : public base_detector, public interactive_detector_alarm<T>
+{public:
+
+	// calback definition, called from the thread that adds the sample
+	typedef typename interactive_detector_alarm<T>::call_back _average_limit_call_back ;
+	interactive_shared_average_detector( T id, size_t samples, interactive_pool_duration trigger_level, _average_limit_call_back fcn )
+		: interactive_detector_alarm<T>(id, trigger_level, std::move(fcn))
+		, _samples_count(samples ? samples : 1)
+		, _samples(new std::atomic<int64_t>[samples ? samples : 1])
+		, _next(0)
+		, _sum(0)
+	{
+		for (size_t i = 0; i < _samples_count; i++)
+		{
+			_samples[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	// timming control function, can be called from any thread
+	virtual void set_elapsed_time( const interactive_pool_duration& i )
+	{
+		int64_t v = static_cast<int64_t>(i.count());
+		uint64_t n = _next.fetch_add(1, std::memory_order_relaxed);
+		// replace the oldest value and update the sum with the difference
+		int64_t old = _samples[n % _samples_count].exchange(v, std::memory_order_relaxed);
+		int64_t sum = _sum.fetch_add(v - old, std::memory_order_relaxed) + (v - old);
+
+		if( n + 1 >= _samples_count )
+		{
+			// calculate the averange if the buffer is completed
+			interactive_pool_duration cur( static_cast<interactive_pool_duration::rep>(sum / static_cast<int64_t>(_samples_count)) );
+			// call designed function if it is over the limit
+			this->alarm( cur > this->_trigger_level, cur > this->exit_level(), [cur]() { return cur; } );
+		}
+	}
+
+	// auxiliar method, calculates the time average of the samples in the window
+	interactive_pool_duration average() const
+	{
+		uint64_t n = std::min<uint64_t>(_next.load(std::memory_order_relaxed), _samples_count);
+		return n ? interactive_pool_duration( static_cast<interactive_pool_duration::rep>(_sum.load(std::memory_order_relaxed) / static_cast<int64_t>(n)) ) : interactive_pool_duration(0);
+	}
+
+private:
+	size_t _samples_count;
+	std::unique_ptr< std::atomic<int64_t>[] > _samples;
+	std::atomic<uint64_t> _next;
+	std::atomic<int64_t> _sum;
+};
+
+
+
+/// interactive_shared_peak_detector
+/// Thread safe version of interactive_peak_detector that also counts the peaks and keeps the highest value,
+/// in atomics, so one instance can be shared by all the threads or attached to the pool
+template < class T > class interactive_shared_peak_detector final : public base_detector, public interactive_detector_alarm<T>
+{public:
+
+	// callback prototipe, called from the thread that adds the sample
+	typedef typename interactive_detector_alarm<T>::call_back _peack_detected_call_back ;
+	interactive_shared_peak_detector( T id,  interactive_pool_duration trigger_level, _peack_detected_call_back fcn )
+		: interactive_detector_alarm<T>(id, trigger_level, std::move(fcn))
+		, _peaks(0)
+		, _max(0)
+		{}
+
+	// check the elapsed time comparing it with the configured trigger_level, can be called from any thread
+	virtual void set_elapsed_time( const interactive_pool_duration& i )
+	{
+		int64_t v = static_cast<int64_t>(i.count());
+		int64_t m = _max.load(std::memory_order_relaxed);
+		while (v > m && !_max.compare_exchange_weak(m, v, std::memory_order_relaxed))
+		{
+		}
+		if( i > this->_trigger_level )
+		{
+			_peaks.fetch_add(1, std::memory_order_relaxed);
+		}
+		this->alarm( i > this->_trigger_level, i > this->exit_level(), [&i]() { return i; } );
+	}
+
+	// number of samples above the trigger level
+	uint64_t get_peak_count() const
+	{
+		return _peaks.load(std::memory_order_relaxed);
+	}
+
+	// highest sample seen
+	interactive_pool_duration get_max() const
+	{
+		return interactive_pool_duration( static_cast<interactive_pool_duration::rep>(_max.load(std::memory_order_relaxed)) );
+	}
+
+private:
+	std::atomic<uint64_t> _peaks;
+	std::atomic<int64_t> _max;
+};
+
+
+
+/// interactive_ewma_detector
+/// Exponentially weighted moving average and variance of the times, in constant memory.
+/// Calls the user function when the smoothed value exceeds the trigger level or, if a z-score is given,
+/// when a sample is more than z standard deviations above the smoothed value.
+/// The state is a few atomics updated with compare and swap, so it can be shared by all the threads
+/// or attached to the pool (see set_acquire_detector())
+template < class T > class interactive_ewma_detector final : public base_detector, public interactive_detector_alarm<T>
+{public:
+
+	// calback definition
+	typedef typename interactive_detector_alarm<T>::call_back _ewma_limit_call_back ;
+	// constructor
+	// id			: identifier, at the discretion of the user
+	// alpha		: weight of each new sample, from 0 to 1 (ex. 0.05 ~ the last 20 samples weigh most)
+	// trigger_level: maximum smoothed time, the callback receives the level and the smoothed value
+	// fcn			: user-defined function
+	// z_score		: optional, 0 disables it. When a sample is above mean + z_score * deviation the callback
+	//				  receives that limit and the sample. Checked once 1 / alpha samples have been seen.
+	//				  With set_debounce() it has its own alarm state, that ends when a sample is not above the mean
+	interactive_ewma_detector( T id, double alpha, interactive_pool_duration trigger_level, _ewma_limit_call_back fcn, double z_score = 0 )
+		: interactive_detector_alarm<T>(id, trigger_level, std::move(fcn))
+		, _alpha(alpha)
+		, _z_score(z_score)
+		, _warmup(alpha > 0 ? static_cast<uint64_t>(std::ceil(1.0 / alpha)) : 1)
+		, _count(0)
+		, _mean(0)
+		, _variance(0)
+		{}
+
+	// timming control function, can be called from any thread
+	virtual void set_elapsed_time( const interactive_pool_duration& i )
+	{
+		const double x = static_cast<double>(i.count());
+		const uint64_t n = _count.fetch_add(1, std::memory_order_relaxed);
+
+		// mean, the first sample is taken as it is
+		double old_mean = _mean.load(std::memory_order_relaxed);
+		double new_mean;
+		do
+		{
+			new_mean = (n == 0) ? x : old_mean + _alpha * (x - old_mean);
+		} while (!_mean.compare_exchange_weak(old_mean, new_mean, std::memory_order_relaxed));
+
+		// variance, with the mean seen by this sample
+		const double diff = x - old_mean;
+		double old_variance = _variance.load(std::memory_order_relaxed);
+		double new_variance;
+		do
+		{
+			new_variance = (n == 0) ? 0 : (1.0 - _alpha) * (old_variance + _alpha * diff * diff);
+		} while (!_variance.compare_exchange_weak(old_variance, new_variance, std::memory_order_relaxed));
+
+		if (_z_score > 0 && n >= _warmup)
+		{
+			// compared with the values before this sample
+			const double limit = old_mean + _z_score * std::sqrt(old_variance);
+			this->alarm( _z_state, interactive_pool_duration(static_cast<interactive_pool_duration::rep>(limit)), x > limit, x > old_mean, [&i]() { return i; } );
+		}
+
+		interactive_pool_duration cur(static_cast<interactive_pool_duration::rep>(new_mean));
+		this->alarm( cur > this->_trigger_level, cur > this->exit_level(), [cur]() { return cur; } );
+	}
+
+	// smoothed time
+	interactive_pool_duration mean() const
+	{
+		return interactive_pool_duration(static_cast<interactive_pool_duration::rep>(_mean.load(std::memory_order_relaxed)));
+	}
+
+	// smoothed standard deviation
+	interactive_pool_duration deviation() const
+	{
+		return interactive_pool_duration(static_cast<interactive_pool_duration::rep>(std::sqrt(_variance.load(std::memory_order_relaxed))));
+	}
+
+private:
+	double _alpha;
+	double _z_score;
+	typename interactive_detector_alarm<T>::alarm_state _z_state;	// alarm of the z-score
+	uint64_t _warmup;
+	std::atomic<uint64_t> _count;
+	std::atomic<double> _mean;		// nanoseconds
+	std::atomic<double> _variance;	// nanoseconds^2
+};
+
+
+
+/// interactive_percentile_detector
+/// Calls a user function when a percentile (ex. 99 or 99.9) of the recent times exceeds the trigger level.
+/// summary: the window is made of two generations of histogram buckets (see interactive_latency_histogram).
+/// When the current generation is complete the older one is cleared and takes its place:
+///  - by number of samples each generation holds the whole window, so the percentile is taken over the last
+///    samples to 2 * samples values (never less than requested)
+///  - by time each generation covers half of the window, so the percentile is taken over the last half to full window
+/// The alarm itself is O(1): each generation also counts the samples above the
+/// trigger level, and the percentile is above the level when they are more than (100 - p)% of the window.
+/// It needs enough samples to have one above the percentile (ex. 1000 for p99.9), or the whole window
+/// by samples when it is smaller.
+/// The buckets are only merged to tell the value to the callback.
+/// Atomics only, it can be shared by all the threads or attached to the pool (see set_acquire_detector())
+template < class T > class interactive_percentile_detector final : public base_detector, public interactive_detector_alarm<T>
+{public:
 
-} interactive_pool_time;
+	// calback definition, receives the trigger level and the percentile of the window
+	typedef typename interactive_detector_alarm<T>::call_back _percentile_limit_call_back ;
+	// constructor, window by number of samples
+	// id			: identifier, at the discretion of the user
+	// percentile	: percentile to watch, from 0 to 100 (ex. 99.9)
+	// trigger_level: maximum value of the percentile
+	// samples		: size of the window in samples
+	// fcn			: user-defined function
+	interactive_percentile_detector( T id, double percentile, interactive_pool_duration trigger_level, size_t samples, _percentile_limit_call_back fcn )
+		: interactive_percentile_detector( id, percentile, trigger_level, fcn )
+	{
+		_samples = std::max<uint64_t>(1, samples);
+		_min_samples = std::min(_min_samples, _samples);
+	}
 
+	// constructor, window by time (ex. std::chrono::seconds(10))
+	interactive_percentile_detector( T id, double percentile, interactive_pool_duration trigger_level, interactive_pool_duration window, _percentile_limit_call_back fcn )
+		: interactive_percentile_detector( id, percentile, trigger_level, fcn )
+	{
+		_half_time = std::max<int64_t>(1, static_cast<int64_t>(window.count() / 2));
+		_rotate_at.store(now() + _half_time, std::memory_order_relaxed);
+	}
 
-/// interactive_pool
-/// main class , created on 2026-06-20 
-/// author <roni.gonzalez@interconetica.com>
-/// summary: interactive_pool try yop be a template class that manages a simple pool of resources
-/// giving an option of monitoring the pool load 
-template <class T> class  interactive_pool
-{
-public:
-	// defines a pool's item
-	typedef  std::unique_ptr< T > item;
+	// timming control function, can be called from any thread
+	virtual void set_elapsed_time( const interactive_pool_duration& i )
+	{
+		if (_half_time)
+		{
+			const int64_t t = now();
+			if (t >= _rotate_at.load(std::memory_order_relaxed))
+			{
+				rotate(_current.load(std::memory_order_acquire), t);
+			}
+		}
 
-	// Constructor 
-	// size : number of resournces (initial buffer size)
-	// ini_func : function initializer 
-	// init_result : function for receive the initialize results
-	interactive_pool(size_t size)
-		: _initialSize(size)
+		const uint64_t v = (i.count() > 0) ? static_cast<uint64_t>(i.count()) : 0;
+		const size_t cur = _current.load(std::memory_order_acquire);
+		generation& g = _generations[cur];
+		g.counts[interactive_latency_histogram::bucket_of(v)].fetch_add(1, std::memory_order_relaxed);
+		uint64_t m = g.max.load(std::memory_order_relaxed);
+		while (v > m && !g.max.compare_exchange_weak(m, v, std::memory_order_relaxed))
+		{
+		}
+		if (i > this->exit_level())
+		{
+			g.above_exit.fetch_add(1, std::memory_order_relaxed);
+			if (i > this->_trigger_level)
+			{
+				g.above.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		const uint64_t n = g.total.fetch_add(1, std::memory_order_relaxed) + 1;
+
+		// O(1) check of the window, before the rotation so a full generation is always part of it
+		const uint64_t total = _generations[0].total.load(std::memory_order_relaxed) + _generations[1].total.load(std::memory_order_relaxed);
+		const uint64_t above = _generations[0].above.load(std::memory_order_relaxed) + _generations[1].above.load(std::memory_order_relaxed);
+		const uint64_t above_exit = _generations[0].above_exit.load(std::memory_order_relaxed) + _generations[1].above_exit.load(std::memory_order_relaxed);
+		const double limit = _tail * static_cast<double>(total);
+		const bool b_window = total >= _min_samples;
+		this->alarm( b_window && static_cast<double>(above) > limit, b_window && static_cast<double>(above_exit) > limit, [this]() { return value(); } );
+
+		if (_samples && n >= _samples)
+		{
+			rotate(cur, 0);
+		}
+	}
+
+	// value()
+	// current value of the percentile over the window
+	interactive_pool_duration value() const
 	{
-		_freeItems.resize(size);
-		std::for_each(_freeItems.begin(), _freeItems.end(), [](item& i) {i = std::move(std::make_unique<T>()); });
+		return snapshot().percentile(_percentile);
 	}
 
-	//check_before_destruct()
-	// can be called before destruct the pool, detect if exists a size difference between initial size and current size
-	// Throws a exception if some element is not released
-	// * Never calls directly in your destructor. Check the examples to see how to use it.
-	void check_before_destruct()
+	// snapshot()
+	// merged buckets of the window, to ask for any other percentile
+	interactive_histogram_snapshot snapshot() const
 	{
-		std::lock_guard<std::mutex> l(_lock);
-		size_t current = _freeItems.size();
-		if (current != _initialSize)
+		interactive_histogram_snapshot r;
+		r.counts.assign(interactive_latency_histogram::bucket_count, 0);
+		for (size_t i = 0; i < 2; i++)
 		{
-			throw std::runtime_error(std::string(std::string("interactive_pool: Different count of items. Pool was created with [") + std::to_string(_initialSize) + std::string("] but during destruction have [") + std::to_string(current) + std::string("]")));
+			const generation& g = _generations[i];
+			for (size_t b = 0; b < interactive_latency_histogram::bucket_count; b++)
+			{
+				uint64_t c = g.counts[b].load(std::memory_order_relaxed);
+				r.counts[b] += c;
+				r.total += c;
+				r.sum += c * interactive_latency_histogram::bucket_upper(b);
+			}
+			r.max = std::max(r.max, g.max.load(std::memory_order_relaxed));
 		}
+		return r;
 	}
 
-	// Destructor
-	// releases all items
-	virtual ~interactive_pool()
+private:
+	interactive_percentile_detector( T id, double percentile, interactive_pool_duration trigger_level, _percentile_limit_call_back fcn )
+		: interactive_detector_alarm<T>(id, trigger_level, std::move(fcn))
+		, _percentile(percentile)
+		, _tail(1.0 - percentile / 100.0)
+		// enough samples to have at least one above the percentile (ex. 1000 for p99.9)
+		, _min_samples(percentile < 100 ? static_cast<uint64_t>(std::ceil(100.0 / (100.0 - percentile))) : 1)
+		, _samples(0)
+		, _half_time(0)
+		, _generations(new generation[2])
+		, _current(0)
+		, _rotating(false)
+		, _rotate_at(0)
 	{
-		std::for_each(_freeItems.begin(), _freeItems.end(), [](item& i) {i.reset(); });
-		_freeItems.clear();
+		clear(_generations[0]);
+		clear(_generations[1]);
 	}
 
+	static int64_t now()
+	{
+		return static_cast<int64_t>(std::chrono::duration_cast<interactive_pool_duration>(interactive_pool_clock::now().time_since_epoch()).count());
+	}
 
-	// get_item()
-	// returns a item to caller or throw an exception if pool is empty
-	// max_wait_ms		: maximun time, in milliseconds, to wait a free instance.  Once this time has elapsed, an exception will be thrown
-	//					  special values: 
-	//							0 -> try just once.
-	//							Default = numeric_limits<uint32_t>::max()
-	// time_elapsed_ms 	: Time, in milliseconds, it took to get an instance from the thread pool
-	item get_item(uint32_t max_wait_ms = std::numeric_limits<uint32_t>::max(), interactive_pool_time* time_elapsed_ms = nullptr, std::function<bool(item&)> f = {} )
+	struct generation
 	{
-		auto t0 = std::chrono::high_resolution_clock::now();
-		auto t1 = t0;
-		std::chrono::duration<double, std::milli> elapsed;
+		std::atomic<uint64_t> counts[interactive_latency_histogram::bucket_count];
+		std::atomic<uint64_t> total;
+		std::atomic<uint64_t> above;		// samples over the trigger level
+		std::atomic<uint64_t> above_exit;	// samples over the exit level (see set_debounce())
+		std::atomic<uint64_t> max;
+	};
 
-		if (time_elapsed_ms)
+	static void clear(generation& g)
+	{
+		for (size_t b = 0; b < interactive_latency_histogram::bucket_count; b++)
 		{
-			// get initial time point if metric is requested
-			time_elapsed_ms->init = std::chrono::high_resolution_clock::now();
+			g.counts[b].store(0, std::memory_order_relaxed);
 		}
+		g.total.store(0, std::memory_order_relaxed);
+		g.above.store(0, std::memory_order_relaxed);
+		g.above_exit.store(0, std::memory_order_relaxed);
+		g.max.store(0, std::memory_order_relaxed);
+	}
 
-		do
+	// rotate()
+	// the older generation is cleared and becomes the current one. Only one thread does it,
+	// the samples recorded in the older one at the same time are lost.
+	// t : now, for the window by time. If a whole window has passed without samples, both generations are old
+	void rotate(size_t cur, int64_t t)
+	{
+		if (_rotating.exchange(true, std::memory_order_acquire))
+		{
+			return;
+		}
+		if (_current.load(std::memory_order_relaxed) == cur)
 		{
-			{ // lock scope
-				std::lock_guard<std::mutex> l(_lock);
-				
-				if (!_freeItems.empty())
+			clear(_generations[cur ^ 1]);
+			if (_half_time)
+			{
+				if (t >= _rotate_at.load(std::memory_order_relaxed) + _half_time)
 				{
-					// got at least 1 item, reuturn it and remove from pool
-					item j = std::move(_freeItems.front());
-					_freeItems.pop_front();
-					bool b_status_ok = true;
-					// if a check or initialize function is defined, call it
-					if( f )
-					{
-						b_status_ok = f(j) ;
-					}
-					
-					// status ok, return item
-					if(b_status_ok)
-					{
-						if (time_elapsed_ms)
-						{
-							// if metric is requested, calculate elapsed time
-							time_elapsed_ms->finish = std::chrono::high_resolution_clock::now();
-							time_elapsed_ms->elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(time_elapsed_ms->finish - time_elapsed_ms->init);
-						}
-						// return item
-						return j;
-					}
-					else
-					{
-						_freeItems.push_back(std::move(j));
-					}
-					
+					clear(_generations[cur]);
 				}
-			} // end lock scope
+				_rotate_at.store(t + _half_time, std::memory_order_relaxed);
+			}
+			_current.store(cur ^ 1, std::memory_order_release);
+		}
+		_rotating.store(false, std::memory_order_release);
+	}
 
-			// not items available, wait till timeout
-			t1 = std::chrono::high_resolution_clock::now();
-			// used to check timeout
-			elapsed = (t1 - t0);
-			// rest a little 
-			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+private:
+	double _percentile;
+	double _tail;
+	uint64_t _min_samples;
+	uint64_t _samples;			// window by samples (size of each generation), else 0
+	int64_t _half_time;			// window by time (nanoseconds), else 0
+	std::unique_ptr< generation[] > _generations;
+	std::atomic<size_t> _current;
+	std::atomic<bool> _rotating;
+	std::atomic<int64_t> _rotate_at;
+};
 
-		} while (elapsed.count() < max_wait_ms);
 
-		// no free items
-		throw std::runtime_error("interactive_pool: All items are in use");
+
+/// interactive_time_window_average_detector
+/// Calls the user function when the average of the times of the last period (ex. the last 10 seconds)
+/// exceeds the trigger level. Unlike interactive_average_detector, that takes the last n samples, the window
+/// means the same at any rate of requests.
+/// summary: the window is a circular array of buckets of a fixed interval (ex. 100ms), each with the count
+/// and the sum of its samples. A bucket is cleared when the clock reaches it again, so the memory is fixed.
+/// The totals of the previous buckets are added up once per interval, so each sample costs the same
+/// whatever the number of buckets.
+/// Atomics only, it can be shared by all the threads or attached to the pool (see set_acquire_detector())
+template < class T > class interactive_time_window_average_detector final : public base_detector, public interactive_detector_alarm<T>
+{public:
+
+	// calback definition
+	typedef typename interactive_detector_alarm<T>::call_back _average_limit_call_back ;
+	// constructor
+	// id			: identifier, at the discretion of the user
+	// window		: period of the average (ex. std::chrono::seconds(10))
+	// interval		: size of each bucket (ex. std::chrono::milliseconds(100)), the window moves in these steps
+	// trigger_level: maximum average
+	// fcn			: user-defined function
+	// min_samples	: samples needed in the window before the average is checked
+	interactive_time_window_average_detector( T id, interactive_pool_duration window, interactive_pool_duration interval, interactive_pool_duration trigger_level, _average_limit_call_back fcn, uint64_t min_samples = 1 )
+		: interactive_detector_alarm<T>(id, trigger_level, std::move(fcn))
+		, _interval(std::max<int64_t>(1, interval.count()))
+		, _bucket_count(static_cast<size_t>(std::max<int64_t>(1, (window.count() + _interval - 1) / _interval)))
+		, _buckets(new bucket[_bucket_count])
+		, _min_samples(min_samples ? min_samples : 1)
+		, _past_step(-1)
+		, _past_count(0)
+		, _past_sum(0)
+	{
+		for (size_t i = 0; i < _bucket_count; i++)
+		{
+			_buckets[i].step.store(-1, std::memory_order_relaxed);
+			_buckets[i].count.store(0, std::memory_order_relaxed);
+			_buckets[i].sum.store(0, std::memory_order_relaxed);
+		}
 	}
 
-	// get_available_count()
-	// returns the number of free items in the pool
-	size_t get_available_count()
+	// timming control function, can be called from any thread
+	virtual void set_elapsed_time( const interactive_pool_duration& i )
 	{
-		std::lock_guard<std::mutex> l(_lock);
-		return _freeItems.size();
+		const int64_t step = current_step();
+		bucket& b = _buckets[static_cast<size_t>(step) % _bucket_count];
+		int64_t old = b.step.load(std::memory_order_acquire);
+		if (old != step && b.step.compare_exchange_strong(old, step, std::memory_order_acq_rel))
+		{
+			// first sample of this interval, the bucket had an old one. Samples added at the same time may be lost
+			b.count.store(0, std::memory_order_relaxed);
+			b.sum.store(0, std::memory_order_relaxed);
+		}
+		b.count.fetch_add(1, std::memory_order_relaxed);
+		b.sum.fetch_add(static_cast<uint64_t>(i.count() > 0 ? i.count() : 0), std::memory_order_relaxed);
+
+		int64_t known = _past_step.load(std::memory_order_acquire);
+		if (known != step && _past_step.compare_exchange_strong(known, step, std::memory_order_acq_rel))
+		{
+			// first sample of the interval in this detector, adds up the previous buckets of the window.
+			// Meanwhile the other threads may use the totals of the previous interval
+			uint64_t past_count = 0;
+			uint64_t past_sum = 0;
+			scan(step, false, past_count, past_sum);
+			_past_count.store(past_count, std::memory_order_relaxed);
+			_past_sum.store(past_sum, std::memory_order_relaxed);
+		}
+
+		const uint64_t count = _past_count.load(std::memory_order_relaxed) + b.count.load(std::memory_order_relaxed);
+		const uint64_t sum = _past_sum.load(std::memory_order_relaxed) + b.sum.load(std::memory_order_relaxed);
+		interactive_pool_duration cur(count ? static_cast<interactive_pool_duration::rep>(sum / count) : 0);
+		if (count >= _min_samples)
+		{
+			this->alarm( cur > this->_trigger_level, cur > this->exit_level(), [cur]() { return cur; } );
+		}
 	}
 
-	// set_connection()
-	// push the connection back to the pool
-	void set_item(item& r)
+	// auxiliar method, average of the samples in the window
+	interactive_pool_duration average() const
 	{
-		std::lock_guard<std::mutex> l(_lock);
-		_freeItems.push_back(std::move(r));
+		uint64_t count = 0;
+		return average(current_step(), count);
+	}
+
+	// number of samples in the window
+	uint64_t get_sample_count() const
+	{
+		uint64_t count = 0;
+		average(current_step(), count);
+		return count;
 	}
-	
 
 private:
-	size_t				 _initialSize;
-	std::deque < item > _freeItems;
-	std::mutex		     _lock;
-};
+	int64_t current_step() const
+	{
+		return std::chrono::duration_cast<interactive_pool_duration>(interactive_pool_clock::now().time_since_epoch()).count() / _interval;
+	}
+
+	interactive_pool_duration average( int64_t step, uint64_t& count ) const
+	{
+		uint64_t sum = 0;
+		scan(step, true, count, sum);
+		return interactive_pool_duration(count ? static_cast<interactive_pool_duration::rep>(sum / count) : 0);
+	}
 
+	// scan()
+	// adds up the buckets of the window that ends at step, with or without the bucket of step
+	void scan( int64_t step, bool b_current, uint64_t& count, uint64_t& sum ) const
+	{
+		count = 0;
+		sum = 0;
+		const int64_t last = b_current ? step : step - 1;
+		for (size_t i = 0; i < _bucket_count; i++)
+		{
+			const bucket& b = _buckets[i];
+			int64_t s = b.step.load(std::memory_order_acquire);
+			if (s > step - static_cast<int64_t>(_bucket_count) && s <= last)
+			{
+				count += b.count.load(std::memory_order_relaxed);
+				sum += b.sum.load(std::memory_order_relaxed);
+			}
+		}
+	}
 
+	struct bucket
+	{
+		std::atomic<int64_t> step;		// interval of the samples, -1 if never used
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> sum;		// nanoseconds
+	};
 
+private:
+	int64_t _interval;		// nanoseconds
+	size_t _bucket_count;
+	std::unique_ptr< bucket[] > _buckets;
+	uint64_t _min_samples;
+	// totals of the window before the current interval
+	std::atomic<int64_t> _past_step;
+	std::atomic<uint64_t> _past_count;
+	std::atomic<uint64_t> _past_sum;
+};
 
-/// base class for detectors
-typedef struct tag_base_detector { virtual void set_elapsed_time(const uint32_t&) = 0; } base_detector;
 
 
-/// interactive_average_detector
-/// Metric facilities function, call a specific function when the average of 
-/// last "n" calls to get_item exceed the limit set in milliseconds
-template < class T > class interactive_average_detector : public base_detector
+/// interactive_composite_detector
+/// Feeds each sample to several detectors, ex. peak, average and percentile alarms on the same handler.
+/// The list of detectors is fixed at compile time. Final detectors (all the ones of this library) are
+/// called directly (no virtual call) and can be inlined, the composite itself is the only virtual call.
+/// Any other type (ex. base_detector& or a class that can be derived) is called through the virtual
+/// function, so the overrides of a derived object are never skipped.
+/// The detectors are not copied, they must outlive the composite. Use interactive_make_composite_detector()
+/// to deduce the types: auto all = interactive_make_composite_detector(peak, average);
+template < class... D > class interactive_composite_detector final : public base_detector
 {public:
 
-	// calback definition
-	typedef std::function<void(T,  uint32_t, uint32_t)> _average_limit_call_back ;
-	interactive_average_detector( T id, size_t samples , uint32_t trigger_level, _average_limit_call_back fcn )
-		: _id(id)
-		, _samples_count(samples), _samples(samples), _trigger_level(trigger_level) , _lcall_back(fcn)
+	explicit interactive_composite_detector( D&... detectors )
+		: _detectors(&detectors...)
 		{}
 
-	// timming control function
-	virtual void set_elapsed_time( const uint32_t& i )
+	// timming control function, given to every detector in order
+	virtual void set_elapsed_time( const interactive_pool_duration& i )
 	{
-		if( _samples.size() >= _samples_count )
-		{
-			// remove oldest value if buffer is full
-			_samples.pop_front();
-		} 
-		
-		// add the received interval to buffer
-		_samples.push_back(i);
-		
-		if( _samples.size() == _samples_count )
-		{
-			// calculate the averange if the buffer is completed
-			uint32_t cur = average();
-			if( cur > _trigger_level )
-			{
-				// call designed function
-				_lcall_back( _id, _trigger_level, cur );
-			}
-		}
+		feed(i, std::index_sequence_for<D...>());
 	}
-	
-	// auxiliar method, calculates the time average of all samples
-	uint32_t average() const 
+
+private:
+	template < size_t... I >
+	void feed( const interactive_pool_duration& i, std::index_sequence<I...> )
 	{
-		return _samples.empty()? 0 :
-			((std::accumulate(_samples.begin(), _samples.end(), 0)) / static_cast<uint32_t>(_samples.size())) ;
+		(void)std::initializer_list<int>{ (feed_one(std::get<I>(_detectors), i, std::is_final<D>()), 0)... };
 	}
-	
+
+	// final detector, the object can not be of a derived type: direct call
+	template < class X >
+	static void feed_one( X* d, const interactive_pool_duration& i, std::true_type )
+	{
+		d->X::set_elapsed_time(i);
+	}
+
+	// any other type may refer to a derived object, virtual call
+	template < class X >
+	static void feed_one( X* d, const interactive_pool_duration& i, std::false_type )
+	{
+		d->set_elapsed_time(i);
+	}
+
 private:
-	T _id;
-	size_t _samples_count;
-	std::deque<uint32_t> _samples;
-	uint32_t _trigger_level;
-	_average_limit_call_back _lcall_back;
+	std::tuple< D*... > _detectors;
 };
 
+template < class... D >
+interactive_composite_detector< D... > interactive_make_composite_detector( D&... detectors )
+{
+	return interactive_composite_detector< D... >(detectors...);
+}
 
 
-/// interactive_peak_detector
-/// Calls a user function each time that the elapsed time to get a item in the pool
-/// exceeds the set trigger value
-template < class T > class interactive_peak_detector : public base_detector
+
+/// interactive_hold_watchdog
+/// Scans periodically the items that are out of a pool and calls a user function when one of them
+/// has been held longer than the trigger level. Unlike the detectors, that see the times once the item
+/// is back, the watchdog reports the stuck callers while they are still stuck.
+/// Each lease is reported once. It enables the lease registry of the pool (see enable_lease_registry())
+template < class T, class Pool > class interactive_hold_watchdog
 {public:
 
-	// callback prototipe
-	typedef std::function<void(T,  uint32_t, uint32_t)> _peack_detected_call_back ;
+	// callback prototipe, same as the detectors
+	typedef std::function<void(T,  interactive_pool_duration, interactive_pool_duration)> _long_hold_call_back ;
 	// constructor
-	// id			: identifier, at the discretion of the user, to identify the thread or instances that have issued the peak signal. 
-	// trigger_level: Maximum time in milliseconds. If this time is exceeded while waiting for the free item in the pool. 
-	// 				  The function designated as callback is called. It does not affect the wait for items pool.
-	// fcn			: user-defined function, called when peak detection occurs
+	// id			: identifier, at the discretion of the user, reported in the callback
+	// pool			: pool to watch, it must outlive the watchdog
+	// trigger_level: maximum hold time
+	// interval		: time between scans
+	// fcn			: user-defined function, called from the watchdog thread
 	//				  parameters :
 	//					id: Defined by user
 	//					level: conffigured trigger level
-	//					elapsed_time: detected peak value
-	interactive_peak_detector( T id,  uint32_t trigger_level, _peack_detected_call_back fcn )
+	//					value: time the item has been held so far
+	interactive_hold_watchdog( T id, Pool* pool, interactive_pool_duration trigger_level, interactive_pool_duration interval, _long_hold_call_back fcn )
 		: _id(id)
+		, _pool(pool)
 		, _trigger_level(trigger_level)
+		, _interval(interval)
 		, _lcall_back(fcn)
-		{}
+		, _stop(false)
+	{
+		_pool->enable_lease_registry();
+		_thread = std::thread(&interactive_hold_watchdog::run, this);
+	}
 
-	// check the elapsed time comparing it with the configured trigger_level
-	// calls user callback function f necessary
-	virtual void set_elapsed_time( const uint32_t& i )
+	// destructor, stops the scans
+	virtual ~interactive_hold_watchdog()
+	{
+		{
+			std::lock_guard<std::mutex> l(_lock);
+			_stop = true;
+		}
+		_cv.notify_one();
+		_thread.join();
+	}
+
+	// scan()
+	// checks the outstanding leases now, called by the watchdog thread on each interval
+	void scan()
+	{
+		std::vector< interactive_pool_lease_info > leases = _pool->outstanding_leases();
+		std::vector< reported > still;
+		for (const interactive_pool_lease_info& i : leases)
+		{
+			if (i.held <= _trigger_level)
+			{
+				continue;
+			}
+			reported r = { i.item, i.checkout };
+			if (std::find(_reported.begin(), _reported.end(), r) == _reported.end())
+			{
+				_lcall_back( _id, _trigger_level, i.held );
+			}
+			still.push_back(r);
+		}
+		// forget the leases already returned
+		_reported.swap(still);
+	}
+
+private:
+	void run()
 	{
-		if( i > _trigger_level )
+		std::unique_lock<std::mutex> l(_lock);
+		while (!_stop)
 		{
-			_lcall_back( _id, _trigger_level, i );
+			_cv.wait_for(l, _interval);
+			if (_stop)
+			{
+				break;
+			}
+			l.unlock();
+			scan();
+			l.lock();
 		}
 	}
+
+	// a lease is identified by its item and its checkout time
+	struct reported
+	{
+		const void* item;
+		interactive_pool_clock::time_point checkout;
+		bool operator==(const reported& o) const { return item == o.item && checkout == o.checkout; }
+	};
+
 private:
 	T _id;
-	uint32_t _trigger_level;
-	_peack_detected_call_back _lcall_back;
+	Pool* _pool;
+	interactive_pool_duration _trigger_level;
+	interactive_pool_duration _interval;
+	_long_hold_call_back _lcall_back;
+	std::vector< reported > _reported;
+	bool _stop;
+	std::mutex _lock;
+	std::condition_variable _cv;
+	std::thread _thread;
 };
 
 
@@ -272,28 +3210,48 @@ private:
 /// interactive_pool_scoped_connection
 /// helper for interactive_pool, releases the instance once
 /// the object is out of scope
-template < class T> class interactive_pool_scoped_connection
+template < class T, class Pool = interactive_pool<T> > class interactive_pool_scoped_connection
 { public:
 	// constructor
 	interactive_pool_scoped_connection( 
-		interactive_pool<T>* pool							// instance of interactive_pool
+		Pool* pool											// instance of interactive_pool
 		, uint32_t max_wait_ms = 0							// maximun time, in milliseconds, to wait a free instance.  Once this time has elapsed, an exception will be thrown
 		, interactive_pool_time* time_elapsed_ms = nullptr	// if metric is desired a interactive_pool_time instance
 		, base_detector* detector = nullptr					// if want to use a detector for reporting and alarms 
-		, std::function<bool(typename interactive_pool<T>::item&)> f = {} 	// if want to test or initialize the item
+		, std::function<bool(typename Pool::item&)> f = {} 	// if want to test or initialize the item
 	) :_p(nullptr) , _pool(pool), _detector(detector)
 	{
 		(_p) = _pool->get_item(max_wait_ms, time_elapsed_ms, f);
 		if( _detector && time_elapsed_ms)
 		{
-			_detector->set_elapsed_time(static_cast<uint32_t>(time_elapsed_ms->elapsed_time.count()));
+			_detector->set_elapsed_time(time_elapsed_ms->elapsed_time);
 		}
 	}
 	
 	// direct access the content
-	typename interactive_pool<T>::item& operator->() const
+	typename Pool::item& operator->() const
+	{
+		return (typename Pool::item&) _p;
+	}
+
+	// tag()
+	// attaches a caller tag to the item, see interactive_pool::tag_item()
+	void tag(const char* t)
+	{
+		if (_p && _pool)
+		{
+			_pool->tag_item(_p, t);
+		}
+	}
+
+	// discard()
+	// the item is broken, it is destroyed and replaced instead of returned. See interactive_pool::discard()
+	void discard()
 	{
-		return (typename interactive_pool<T>::item&) _p;
+		if (_p && _pool)
+		{
+			_pool->discard(_p);
+		}
 	}
 
 	// destructor, releases the item (if any) when is outgoing from scope 
@@ -307,9 +3265,116 @@ template < class T> class interactive_pool_scoped_connection
 
 // members
 private:
-	typename interactive_pool<T>::item _p;
-	interactive_pool<T>* _pool;
+	typename Pool::item _p;
+	Pool* _pool;
 	base_detector* _detector;
 };
 
+
+
+/// interactive_pool_lease
+/// movable handle of an item of interactive_pool, returns the item to the pool when it is destroyed.
+/// Unlike interactive_pool_scoped_connection it has no virtual functions, can be returned from functions,
+/// stored in containers (ex. std::vector for batch operations) and gives direct access to T
+template < class T, class Pool = interactive_pool<T> > class interactive_pool_lease
+{ public:
+	// empty lease
+	interactive_pool_lease() noexcept
+		: _pool(nullptr)
+	{}
+
+	// takes the ownership of an item already obtained from the pool
+	interactive_pool_lease(Pool* pool, typename Pool::item&& i) noexcept
+		: _p(std::move(i)), _pool(pool)
+	{}
+
+	// gets an item from the pool, same parameters as interactive_pool_scoped_connection
+	interactive_pool_lease(
+		Pool* pool											// instance of interactive_pool
+		, uint32_t max_wait_ms								// maximun time, in milliseconds, to wait a free instance.  Once this time has elapsed, an exception will be thrown
+		, interactive_pool_time* time_elapsed_ms = nullptr	// if metric is desired a interactive_pool_time instance
+		, base_detector* detector = nullptr					// if want to use a detector for reporting and alarms 
+		, std::function<bool(typename Pool::item&)> f = {} 	// if want to test or initialize the item
+	) : _pool(pool)
+	{
+		_p = _pool->get_item(max_wait_ms, time_elapsed_ms, f);
+		if (detector && time_elapsed_ms)
+		{
+			detector->set_elapsed_time(time_elapsed_ms->elapsed_time);
+		}
+	}
+
+	interactive_pool_lease(interactive_pool_lease&& o) noexcept
+		: _p(std::move(o._p)), _pool(o._pool)
+	{
+		o._pool = nullptr;
+	}
+
+	interactive_pool_lease& operator=(interactive_pool_lease&& o) noexcept
+	{
+		if (this != &o)
+		{
+			release();
+			_p = std::move(o._p);
+			_pool = o._pool;
+			o._pool = nullptr;
+		}
+		return *this;
+	}
+
+	interactive_pool_lease(const interactive_pool_lease&) = delete;
+	interactive_pool_lease& operator=(const interactive_pool_lease&) = delete;
+
+	// destructor, releases the item (if any)
+	~interactive_pool_lease()
+	{
+		release();
+	}
+
+	// direct access the content
+	T& operator*() const { return *_p; }
+	T* operator->() const { return _p.get(); }
+	T* get() const { return _p.get(); }
+	explicit operator bool() const noexcept { return static_cast<bool>(_p); }
+
+	// tag()
+	// attaches a caller tag to the item, see interactive_pool::tag_item()
+	void tag(const char* t)
+	{
+		if (_p && _pool)
+		{
+			_pool->tag_item(_p, t);
+		}
+	}
+
+	// release()
+	// returns the item to the pool now, the lease becomes empty
+	void release()
+	{
+		if (_p && _pool)
+		{
+			_pool->set_item(_p);
+		}
+		_p.reset();
+		_pool = nullptr;
+	}
+
+	// discard()
+	// the item is broken, it is destroyed and replaced instead of returned. See interactive_pool::discard()
+	void discard()
+	{
+		if (_p && _pool)
+		{
+			_pool->discard(_p);
+		}
+		_p.reset();
+		_pool = nullptr;
+	}
+
+// members
+private:
+	typename Pool::item _p;
+	Pool* _pool;
+};
+
 #endif // INTERACTIVE_POOL__H
\ No newline at end of file
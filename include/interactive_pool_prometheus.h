@@ -0,0 +1,239 @@
+/* .....................................................................
+ * interactive_pool_prometheus
+ * Header only exporter of the interactive_pool metrics in Prometheus
+ * text exposition format
+ * LICENSE: MIT
+ * ..................................................................... */
+
+#ifndef INTERACTIVE_POOL_PROMETHEUS__H
+#define INTERACTIVE_POOL_PROMETHEUS__H
+#include "interactive_pool.h"
+
+#include <cstdio>
+#include <iomanip>
+#include <locale>
+
+
+/// interactive_pool_prometheus_exporter
+/// Renders the counters and latency histograms of all registered pools in Prometheus text format
+/// summary: each pool is registered with a name, used as the "pool" label of all its metrics.
+/// The output can be written to a std::string, to an ostream (ex. the body of a /metrics http answer)
+/// or to a file replaced atomically, for the textfile collector of node_exporter.
+/// Histograms are exported as summaries (p50, p90, p99, p999) when they are enabled in the pool.
+/// The total hold time is the _sum of the hold summary, both need enable_hold_tracking()
+class interactive_pool_prometheus_exporter
+{
+public:
+	// register_pool()
+	// adds a pool (any interactive_pool instantiation). The pool must outlive its registration
+	template <class P> void register_pool(const std::string& name, P* pool)
+	{
+		entry e;
+		e.name = name;
+		e.stats = [pool]() { return pool->stats(); };
+		e.acquire = [pool]() { return pool->acquire_histogram(); };
+		e.hold = [pool]() { return pool->hold_histogram(); };
+
+		std::lock_guard<std::mutex> l(_lock);
+		unregister_locked(name);
+		_pools.push_back(e);
+	}
+
+	// unregister_pool()
+	// removes a pool, call it before destroying the pool
+	void unregister_pool(const std::string& name)
+	{
+		std::lock_guard<std::mutex> l(_lock);
+		unregister_locked(name);
+	}
+
+	// write()
+	// renders all metrics to a stream
+	void write(std::ostream& os) const
+	{
+		std::vector<sample> samples;
+		{
+			std::lock_guard<std::mutex> l(_lock);
+			for (const entry& e : _pools)
+			{
+				sample s;
+				s.label = "pool=\"" + escape(e.name) + "\"";
+				s.stats = e.stats();
+				s.acquire = e.acquire();
+				s.hold = e.hold();
+				samples.push_back(std::move(s));
+			}
+		}
+
+		std::ostringstream out;
+		out.imbue(std::locale::classic());
+		out << std::setprecision(9);
+
+		family(out, "interactive_pool_items", "gauge", "Items of the pool", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.total); });
+		family(out, "interactive_pool_free_items", "gauge", "Items ready to be used", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.free); });
+		family(out, "interactive_pool_in_use_items", "gauge", "Items held by callers", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.in_use); });
+		family(out, "interactive_pool_peak_in_use_items", "gauge", "Highest number of items in use", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.peak_in_use); });
+		family(out, "interactive_pool_waiters", "gauge", "Callers waiting for an item", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.waiters); });
+		family(out, "interactive_pool_acquires_total", "counter", "Items given to callers", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.acquires); });
+		family(out, "interactive_pool_timeouts_total", "counter", "Acquisitions that ended without item", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.timeouts); });
+		family(out, "interactive_pool_validation_failures_total", "counter", "Items rejected by the validation", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.validation_failures); });
+		family(out, "interactive_pool_items_created_total", "counter", "Items created", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.created); });
+		family(out, "interactive_pool_items_destroyed_total", "counter", "Items destroyed by discard", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.destroyed); });
+		family(out, "interactive_pool_wait_seconds_total", "counter", "Total time waited for items", samples,
+			[](const sample& s) { return seconds(s.stats.wait_time); });
+
+		family(out, "interactive_pool_lock_acquisitions_total", "counter", "Times the pool lock was taken (instrumented lock only)", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.lock_acquisitions); });
+		family(out, "interactive_pool_lock_contended_total", "counter", "Times the pool lock was busy (instrumented lock only)", samples,
+			[](const sample& s) { return static_cast<double>(s.stats.lock_contended); });
+		family(out, "interactive_pool_lock_wait_seconds_total", "counter", "Total time waiting for the pool lock (instrumented lock only)", samples,
+			[](const sample& s) { return seconds(s.stats.lock_wait_time); });
+		family(out, "interactive_pool_lock_hold_seconds_total", "counter", "Total time the pool lock was held (instrumented lock only)", samples,
+			[](const sample& s) { return seconds(s.stats.lock_hold_time); });
+		family(out, "interactive_pool_lock_max_hold_seconds", "gauge", "Longest critical section of the pool lock (instrumented lock only)", samples,
+			[](const sample& s) { return seconds(s.stats.lock_max_hold); });
+
+		summary(out, "interactive_pool_acquire_seconds", "Time to get an item", samples,
+			[](const sample& s) -> const interactive_histogram_snapshot& { return s.acquire; });
+		summary(out, "interactive_pool_hold_seconds", "Time an item is held", samples,
+			[](const sample& s) -> const interactive_histogram_snapshot& { return s.hold; });
+
+		os << out.str();
+	}
+
+	// render()
+	// renders all metrics to a string
+	std::string render() const
+	{
+		std::ostringstream os;
+		write(os);
+		return os.str();
+	}
+
+	// write_file()
+	// writes all metrics to a temporary file and renames it to path, so readers never see a partial file
+	// returns false if the file could not be written
+	bool write_file(const std::string& path) const
+	{
+		std::string tmp = path + ".tmp";
+		{
+			std::ofstream f(tmp, std::ios::out | std::ios::trunc);
+			if (!f)
+			{
+				return false;
+			}
+			write(f);
+			f.flush();
+			if (!f)
+			{
+				return false;
+			}
+		}
+#if defined(_WIN32)
+		// rename does not replace an existing file on windows
+		std::remove(path.c_str());
+#endif
+		return std::rename(tmp.c_str(), path.c_str()) == 0;
+	}
+
+private:
+	struct entry
+	{
+		std::string name;
+		std::function<interactive_pool_stats()> stats;
+		std::function<interactive_histogram_snapshot()> acquire;
+		std::function<interactive_histogram_snapshot()> hold;
+	};
+
+	struct sample
+	{
+		std::string label;
+		interactive_pool_stats stats;
+		interactive_histogram_snapshot acquire;
+		interactive_histogram_snapshot hold;
+	};
+
+	void unregister_locked(const std::string& name)
+	{
+		_pools.erase(std::remove_if(_pools.begin(), _pools.end(), [&name](const entry& e) { return e.name == name; }), _pools.end());
+	}
+
+	static double seconds(const interactive_pool_duration& d)
+	{
+		return std::chrono::duration<double>(d).count();
+	}
+
+	// label values escape \, " and new line
+	static std::string escape(const std::string& v)
+	{
+		std::string r;
+		for (char c : v)
+		{
+			switch (c)
+			{
+			case '\\': r += "\\\\"; break;
+			case '"': r += "\\\""; break;
+			case '\n': r += "\\n"; break;
+			default: r += c;
+			}
+		}
+		return r;
+	}
+
+	template <class F> static void family(std::ostream& out, const char* name, const char* type, const char* help, const std::vector<sample>& samples, F value)
+	{
+		if (samples.empty())
+		{
+			return;
+		}
+		out << "# HELP " << name << " " << help << "\n";
+		out << "# TYPE " << name << " " << type << "\n";
+		for (const sample& s : samples)
+		{
+			out << name << "{" << s.label << "} " << value(s) << "\n";
+		}
+	}
+
+	template <class F> static void summary(std::ostream& out, const char* name, const char* help, const std::vector<sample>& samples, F histogram)
+	{
+		bool b_header = false;
+		for (const sample& s : samples)
+		{
+			const interactive_histogram_snapshot& h = histogram(s);
+			if (h.counts.empty())
+			{
+				// histogram not enabled in this pool
+				continue;
+			}
+			if (!b_header)
+			{
+				out << "# HELP " << name << " " << help << "\n";
+				out << "# TYPE " << name << " summary\n";
+				b_header = true;
+			}
+			const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+			for (double q : quantiles)
+			{
+				out << name << "{" << s.label << ",quantile=\"" << q << "\"} " << seconds(h.percentile(q * 100.0)) << "\n";
+			}
+			out << name << "_sum{" << s.label << "} " << seconds(interactive_pool_duration(static_cast<interactive_pool_duration::rep>(h.sum))) << "\n";
+			out << name << "_count{" << s.label << "} " << h.total << "\n";
+		}
+	}
+
+private:
+	std::vector< entry > _pools;
+	mutable std::mutex _lock;
+};
+
+#endif // INTERACTIVE_POOL_PROMETHEUS__H